@@ -0,0 +1,64 @@
+#include <asio.hpp>
+#include <corio.hpp>
+#include <iostream>
+#include <marker.hpp>
+#include <vector>
+
+constexpr std::size_t n = 100'000;
+
+corio::Lazy<void> corio_child() {
+    // Busy tasks, as under overload
+    while (true) {
+        co_await corio::this_coro::yield;
+    }
+}
+
+corio::Lazy<void> corio_test(corio::AbortMode mode) {
+    std::vector<corio::Task<void>> tasks;
+    tasks.reserve(n);
+    for (std::size_t i = 0; i < n; i++) {
+        tasks.push_back(co_await corio::spawn(corio_child()));
+    }
+    for (auto &task : tasks) {
+        task.abort(mode);
+    }
+    std::size_t cancelled = 0;
+    for (auto &task : tasks) {
+        try {
+            co_await task;
+        } catch (const corio::CancellationError &) {
+            cancelled++;
+        }
+    }
+    if (cancelled != n) {
+        std::cerr << "wrong count: " << cancelled << std::endl;
+    }
+}
+
+auto launch_corio_test(std::size_t threads, corio::AbortMode mode) {
+    return [threads, mode]() {
+        corio::WorkStealingPool pool(threads);
+        corio::WorkStealingPool::serial_executor_type serial(
+            pool.get_executor());
+        corio::block_on(serial, corio_test(mode));
+    };
+}
+
+int main() {
+    for (std::size_t threads = 1; threads <= 32; threads *= 4) {
+        for (std::size_t i = 0; i < 3; i++) {
+            auto dur = marker::measured(
+                launch_corio_test(threads, corio::AbortMode::immediate))();
+            std::cerr << "corio immediate (" << threads << " threads): " << dur
+                      << std::endl;
+        }
+        for (std::size_t i = 0; i < 3; i++) {
+            auto dur = marker::measured(
+                launch_corio_test(threads, corio::AbortMode::deferred))();
+            std::cerr << "corio deferred (" << threads << " threads): " << dur
+                      << std::endl;
+        }
+    }
+
+    return 0;
+}
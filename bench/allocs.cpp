@@ -0,0 +1,99 @@
+#include <asio.hpp>
+#include <atomic>
+#include <corio.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+// Counts the calls to the global operator new
+static std::atomic<std::size_t> allocations = 0;
+
+void *operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+constexpr std::size_t n = 100'000;
+
+template <typename F>
+corio::Lazy<void> count_allocations(const char *name, F make_test) {
+    // Warm up the pools and caches before counting
+    co_await make_test(n / 10);
+    std::size_t before = allocations.load();
+    co_await make_test(n);
+    std::size_t after = allocations.load();
+    std::cerr << name << ": " << static_cast<double>(after - before) / n
+              << " allocations per operation" << std::endl;
+}
+
+template <typename F> void report(const char *name, F make_test) {
+    asio::io_context ctx{ASIO_CONCURRENCY_HINT_1};
+    corio::spawn_background(ctx.get_executor(),
+                            count_allocations(name, make_test));
+    ctx.run();
+}
+
+corio::Lazy<void> yield_test(std::size_t count) {
+    for (std::size_t i = 0; i < count; i++) {
+        co_await corio::this_coro::yield;
+    }
+}
+
+corio::Lazy<void> post_test(std::size_t count) {
+    auto ex = co_await corio::this_coro::executor;
+    for (std::size_t i = 0; i < count; i++) {
+        co_await asio::post(ex, corio::use_corio);
+    }
+}
+
+corio::Lazy<void> lazy_test(std::size_t count) {
+    auto f = []() -> corio::Lazy<int> { co_return 42; };
+    for (std::size_t i = 0; i < count; i++) {
+        co_await f();
+    }
+}
+
+corio::Lazy<void> any_awaitable_test(std::size_t count) {
+    auto f = []() -> corio::Lazy<int> { co_return 42; };
+    for (std::size_t i = 0; i < count; i++) {
+        corio::AnyAwaitable<int> awaitable = f();
+        co_await awaitable;
+    }
+}
+
+corio::Lazy<void> read_test(std::size_t count) {
+    auto ex = co_await corio::this_coro::executor;
+    asio::local::stream_protocol::socket s1(ex), s2(ex);
+    asio::local::connect_pair(s1, s2);
+    char data = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        co_await asio::async_write(s1, asio::buffer(&data, 1),
+                                   corio::use_corio);
+        co_await asio::async_read(s2, asio::buffer(&data, 1),
+                                  corio::use_corio);
+    }
+}
+
+corio::Lazy<void> gather_test(std::size_t count) {
+    auto f = []() -> corio::Lazy<int> { co_return 42; };
+    for (std::size_t i = 0; i < count; i++) {
+        co_await corio::gather(f(), f());
+    }
+}
+
+int main() {
+    report("yield", yield_test);
+    report("post", post_test);
+    report("lazy", lazy_test);
+    report("any awaitable", any_awaitable_test);
+    report("socket write + read", read_test);
+    report("gather", gather_test);
+    return 0;
+}
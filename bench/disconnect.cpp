@@ -0,0 +1,96 @@
+#include <asio.hpp>
+#include <corio.hpp>
+#include <iostream>
+#include <marker.hpp>
+
+using tcp = asio::ip::tcp;
+
+constexpr std::size_t n = 20'000;
+constexpr std::size_t concurrency = 100;
+
+// Each connection sends one message, reads the echo and disconnects, so that
+// every server session ends with an EOF
+
+corio::Lazy<void> throwing_session(tcp::socket socket) {
+    std::array<char, 64> data;
+    try {
+        while (true) {
+            auto len = co_await socket.async_read_some(asio::buffer(data),
+                                                       corio::use_corio);
+            co_await asio::async_write(socket, asio::buffer(data, len),
+                                       corio::use_corio);
+        }
+    } catch (const asio::system_error &) {
+    }
+}
+
+corio::Lazy<void> nothrow_session(tcp::socket socket) {
+    std::array<char, 64> data;
+    while (true) {
+        auto [ec, len] = co_await socket.async_read_some(
+            asio::buffer(data), corio::use_corio_nothrow);
+        if (ec) {
+            break;
+        }
+        auto [write_ec, _] = co_await asio::async_write(
+            socket, asio::buffer(data, len), corio::use_corio_nothrow);
+        if (write_ec) {
+            break;
+        }
+    }
+}
+
+template <typename Session>
+corio::Lazy<void> server(tcp::acceptor &acceptor, Session session) {
+    auto ex = co_await corio::this_coro::executor;
+    for (std::size_t i = 0; i < n; i++) {
+        tcp::socket socket(ex);
+        co_await acceptor.async_accept(socket, corio::use_corio);
+        co_await corio::spawn_background(session(std::move(socket)));
+    }
+}
+
+corio::Lazy<void> client(tcp::endpoint endpoint, std::size_t count) {
+    auto ex = co_await corio::this_coro::executor;
+    std::array<char, 16> data = {};
+    for (std::size_t i = 0; i < count; i++) {
+        tcp::socket socket(ex);
+        co_await socket.async_connect(endpoint, corio::use_corio);
+        co_await asio::async_write(socket, asio::buffer(data),
+                                   corio::use_corio);
+        co_await asio::async_read(socket, asio::buffer(data),
+                                  corio::use_corio);
+    }
+}
+
+template <typename Session> void launch_test(Session session) {
+    asio::io_context ctx{ASIO_CONCURRENCY_HINT_1};
+    tcp::acceptor acceptor(ctx,
+                           tcp::endpoint(asio::ip::address_v4::loopback(), 0));
+    auto endpoint = acceptor.local_endpoint();
+
+    corio::spawn_background(ctx.get_executor(), server(acceptor, session));
+    for (std::size_t i = 0; i < concurrency; i++) {
+        corio::spawn_background(ctx.get_executor(),
+                                client(endpoint, n / concurrency));
+    }
+    ctx.run();
+}
+
+void launch_throwing_test() { launch_test(throwing_session); }
+
+void launch_nothrow_test() { launch_test(nothrow_session); }
+
+int main() {
+    for (std::size_t i = 0; i < 6; i++) {
+        auto dur = marker::measured(launch_throwing_test)();
+        std::cerr << "use_corio: " << dur << std::endl;
+    }
+
+    for (std::size_t i = 0; i < 6; i++) {
+        auto dur = marker::measured(launch_nothrow_test)();
+        std::cerr << "use_corio_nothrow: " << dur << std::endl;
+    }
+
+    return 0;
+}
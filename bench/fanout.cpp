@@ -0,0 +1,59 @@
+#include <asio.hpp>
+#include <corio.hpp>
+#include <iostream>
+#include <marker.hpp>
+#include <type_traits>
+#include <vector>
+
+constexpr std::size_t n = 100'000;
+
+corio::Lazy<std::size_t> corio_leaf(std::size_t i) {
+    co_await corio::this_coro::yield;
+    std::size_t x = i;
+    for (std::size_t j = 0; j < 100; j++) {
+        x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+    }
+    co_return x;
+}
+
+corio::Lazy<void> corio_test() {
+    std::vector<corio::Task<std::size_t>> tasks;
+    tasks.reserve(n);
+    for (std::size_t i = 0; i < n; i++) {
+        tasks.push_back(co_await corio::spawn(corio_leaf(i)));
+    }
+    co_await corio::gather(tasks);
+}
+
+template <typename Pool> auto launch_corio_test(std::size_t threads) {
+    return [threads]() {
+        Pool pool(threads);
+        if constexpr (std::is_same_v<Pool, corio::WorkStealingPool>) {
+            corio::WorkStealingPool::serial_executor_type serial(
+                pool.get_executor());
+            corio::block_on(serial, corio_test());
+        } else {
+            corio::block_on(asio::make_strand(pool.get_executor()),
+                            corio_test());
+        }
+    };
+}
+
+int main() {
+    for (std::size_t threads = 1; threads <= 64; threads *= 2) {
+        for (std::size_t i = 0; i < 3; i++) {
+            auto launch = launch_corio_test<corio::WorkStealingPool>(threads);
+            auto dur = marker::measured(launch)();
+            std::cerr << "corio (work stealing, " << threads
+                      << " threads): " << dur << std::endl;
+        }
+        for (std::size_t i = 0; i < 3; i++) {
+            auto launch = launch_corio_test<asio::thread_pool>(threads);
+            auto dur = marker::measured(launch)();
+            std::cerr << "corio (thread pool, " << threads
+                      << " threads): " << dur << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,69 @@
+#include <algorithm>
+#include <asio.hpp>
+#include <atomic>
+#include <corio.hpp>
+#include <cstdlib>
+#include <iostream>
+#include <marker.hpp>
+#include <new>
+#include <vector>
+
+// Counts the calls to the global operator new
+static std::atomic<std::size_t> allocations = 0;
+
+void *operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+corio::Lazy<int> corio_child() { co_return 42; }
+
+corio::Lazy<void> corio_test(std::size_t children) {
+    std::vector<corio::Lazy<int>> lazies;
+    lazies.reserve(children);
+    for (std::size_t i = 0; i < children; i++) {
+        lazies.push_back(corio_child());
+    }
+    co_await corio::gather(std::move(lazies));
+}
+
+// Keep the total number of children roughly the same for every size
+std::size_t rounds_of(std::size_t children) {
+    return std::max<std::size_t>(1, 1'000'000 / children);
+}
+
+corio::Lazy<void> corio_rounds(std::size_t children) {
+    for (std::size_t i = 0; i < rounds_of(children); i++) {
+        co_await corio_test(children);
+    }
+}
+
+void launch_corio_test(std::size_t children) {
+    asio::io_context ctx{ASIO_CONCURRENCY_HINT_1};
+    corio::spawn_background(ctx.get_executor(), corio_rounds(children));
+    ctx.run();
+}
+
+int main() {
+    for (std::size_t children = 1; children <= 1'000'000; children *= 10) {
+        for (std::size_t i = 0; i < 3; i++) {
+            std::size_t before = allocations.load();
+            auto dur = marker::measured(launch_corio_test)(children);
+            double per_gather =
+                static_cast<double>(allocations.load() - before) /
+                rounds_of(children);
+            std::cerr << "corio (" << children << " children): " << dur
+                      << ", " << per_gather << " allocations per gather"
+                      << std::endl;
+        }
+    }
+
+    return 0;
+}
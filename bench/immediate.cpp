@@ -6,6 +6,7 @@
 #include <marker.hpp>
 
 constexpr std::size_t n = 3'000'000;
+constexpr std::size_t n_operators = 300'000;
 
 corio::Lazy<void> corio_test() {
     auto ex = co_await corio::this_coro::executor;
@@ -22,6 +23,22 @@ void launch_corio_test() {
     ctx.run();
 }
 
+corio::Lazy<int> corio_ready(int value) { co_return value; }
+
+corio::Lazy<void> corio_operators_test() {
+    using corio::awaitable_operators::operator&&;
+
+    for (std::size_t i = 0; i < n_operators; i++) {
+        co_await (corio_ready(1) && corio_ready(2));
+    }
+}
+
+void launch_corio_operators_test() {
+    asio::io_context ctx{ASIO_CONCURRENCY_HINT_1};
+    corio::spawn_background(ctx.get_executor(), corio_operators_test());
+    ctx.run();
+}
+
 asio::awaitable<void> asio_test() {
     using asio::experimental::awaitable_operators::operator&&;
 
@@ -39,6 +56,22 @@ void launch_asio_test() {
     ctx.run();
 }
 
+asio::awaitable<int> asio_ready(int value) { co_return value; }
+
+asio::awaitable<void> asio_operators_test() {
+    using asio::experimental::awaitable_operators::operator&&;
+
+    for (std::size_t i = 0; i < n_operators; i++) {
+        co_await (asio_ready(1) && asio_ready(2));
+    }
+}
+
+void launch_asio_operators_test() {
+    asio::io_context ctx{ASIO_CONCURRENCY_HINT_1};
+    asio::co_spawn(ctx, asio_operators_test(), asio::detached);
+    ctx.run();
+}
+
 int main() {
     for (std::size_t i = 0; i < 6; i++) {
         auto dur = marker::measured(launch_corio_test)();
@@ -49,5 +82,15 @@ int main() {
         std::cerr << "asio: " << dur << std::endl;
     }
 
+    // Operators over children that complete without suspending
+    for (std::size_t i = 0; i < 6; i++) {
+        auto dur = marker::measured(launch_corio_operators_test)();
+        std::cerr << "corio operators: " << dur << std::endl;
+    }
+    for (std::size_t i = 0; i < 6; i++) {
+        auto dur = marker::measured(launch_asio_operators_test)();
+        std::cerr << "asio operators: " << dur << std::endl;
+    }
+
     return 0;
 }
\ No newline at end of file
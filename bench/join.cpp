@@ -0,0 +1,49 @@
+#include <asio.hpp>
+#include <corio.hpp>
+#include <iostream>
+#include <marker.hpp>
+#include <vector>
+
+constexpr std::size_t n = 100'000;
+
+corio::Lazy<std::size_t> corio_child(std::size_t i) {
+    // Finish on another thread than the one awaiting
+    co_await corio::this_coro::yield;
+    co_return i;
+}
+
+corio::Lazy<void> corio_test() {
+    std::vector<corio::Task<std::size_t>> tasks;
+    tasks.reserve(n);
+    for (std::size_t i = 0; i < n; i++) {
+        tasks.push_back(co_await corio::spawn(corio_child(i)));
+    }
+    std::size_t sum = 0;
+    for (auto &task : tasks) {
+        sum += co_await task;
+    }
+    if (sum != n * (n - 1) / 2) {
+        std::cerr << "wrong sum: " << sum << std::endl;
+    }
+}
+
+auto launch_corio_test(std::size_t threads) {
+    return [threads]() {
+        corio::WorkStealingPool pool(threads);
+        corio::WorkStealingPool::serial_executor_type serial(
+            pool.get_executor());
+        corio::block_on(serial, corio_test());
+    };
+}
+
+int main() {
+    for (std::size_t threads = 1; threads <= 32; threads *= 2) {
+        for (std::size_t i = 0; i < 3; i++) {
+            auto dur = marker::measured(launch_corio_test(threads))();
+            std::cerr << "corio (" << threads << " threads): " << dur
+                      << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include <asio.hpp>
+#include <corio.hpp>
+#include <iostream>
+#include <marker.hpp>
+#include <vector>
+
+constexpr std::size_t n_tasks = 100'000;
+constexpr std::size_t n_rounds = 100;
+constexpr std::size_t n_threads = 32;
+
+// Each round hops to the pool and back to the serial executor of the task
+corio::Lazy<void> corio_ping_pong(asio::any_io_executor pool_ex) {
+    for (std::size_t i = 0; i < n_rounds; i++) {
+        co_await asio::post(pool_ex, corio::use_corio);
+    }
+}
+
+// Children get a serial executor of their own from spawn()
+corio::Lazy<void> corio_test(asio::any_io_executor pool_ex) {
+    std::vector<corio::Task<void>> tasks;
+    tasks.reserve(n_tasks);
+    for (std::size_t i = 0; i < n_tasks; i++) {
+        tasks.push_back(co_await corio::spawn(corio_ping_pong(pool_ex)));
+    }
+    co_await corio::gather(tasks);
+}
+
+// Children are explicitly given an asio strand each
+corio::Lazy<void> corio_strand_test(asio::any_io_executor pool_ex) {
+    std::vector<corio::Task<void>> tasks;
+    tasks.reserve(n_tasks);
+    for (std::size_t i = 0; i < n_tasks; i++) {
+        tasks.push_back(corio::spawn(asio::make_strand(pool_ex),
+                                     corio_ping_pong(pool_ex)));
+    }
+    co_await corio::gather(tasks);
+}
+
+void launch_corio_test() {
+    asio::thread_pool pool(n_threads);
+    corio::block_on(asio::make_strand(pool.get_executor()),
+                    corio_test(pool.get_executor()));
+}
+
+void launch_corio_strand_test() {
+    asio::thread_pool pool(n_threads);
+    corio::block_on(asio::make_strand(pool.get_executor()),
+                    corio_strand_test(pool.get_executor()));
+}
+
+asio::awaitable<void> asio_ping_pong(asio::any_io_executor pool_ex) {
+    for (std::size_t i = 0; i < n_rounds; i++) {
+        co_await asio::post(pool_ex, asio::deferred);
+    }
+}
+
+void launch_asio_test() {
+    asio::thread_pool pool(n_threads);
+    for (std::size_t i = 0; i < n_tasks; i++) {
+        asio::co_spawn(asio::make_strand(pool.get_executor()),
+                       asio_ping_pong(pool.get_executor()), asio::detached);
+    }
+    pool.join();
+}
+
+int main() {
+    for (std::size_t i = 0; i < 6; i++) {
+        auto dur = marker::measured(launch_asio_test)();
+        std::cerr << "asio: " << dur << std::endl;
+    }
+
+    for (std::size_t i = 0; i < 6; i++) {
+        auto dur = marker::measured(launch_corio_strand_test)();
+        std::cerr << "corio (asio strands): " << dur << std::endl;
+    }
+
+    for (std::size_t i = 0; i < 6; i++) {
+        auto dur = marker::measured(launch_corio_test)();
+        std::cerr << "corio (serial executors): " << dur << std::endl;
+    }
+
+    return 0;
+}
@@ -19,6 +19,13 @@ void launch_corio_test() {
     ctx.run();
 }
 
+#if !defined(CORIO_STATIC_EXECUTOR_TYPE) && !defined(CORIO_SINGLE_THREADED)
+void launch_corio_run_test() { corio::run(corio_test(), false); }
+#else
+// run() always runs on the calling thread in this build
+void launch_corio_run_test() { corio::run(corio_test()); }
+#endif
+
 asio::awaitable<void> asio_test() {
     auto ex = co_await asio::this_coro::executor;
 
@@ -44,5 +51,10 @@ int main() {
         std::cerr << "corio: " << dur << std::endl;
     }
 
+    for (std::size_t i = 0; i < 6; i++) {
+        auto dur = marker::measured(launch_corio_run_test)();
+        std::cerr << "corio run: " << dur << std::endl;
+    }
+
     return 0;
 }
\ No newline at end of file
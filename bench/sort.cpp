@@ -2,6 +2,7 @@
 #include <corio.hpp>
 #include <marker.hpp>
 #include <thread>
+#include <type_traits>
 
 template <typename T>
 void merge_sort_normal(T arr[], std::size_t size, T tmp[]) {
@@ -78,6 +79,21 @@ void launch_merge_sort_corio(int arr[], std::size_t size, int tmp[]) {
     corio::run(merge_sort_corio(arr, size, tmp));
 }
 
+// Sorts on a pool of the given size, to see how the runtimes scale
+template <typename Pool> auto launch_merge_sort_scaling(std::size_t threads) {
+    return [threads](int arr[], std::size_t size, int tmp[]) {
+        Pool pool(threads);
+        if constexpr (std::is_same_v<Pool, corio::WorkStealingPool>) {
+            corio::WorkStealingPool::serial_executor_type serial(
+                pool.get_executor());
+            corio::block_on(serial, merge_sort_corio(arr, size, tmp));
+        } else {
+            corio::block_on(asio::make_strand(pool.get_executor()),
+                            merge_sort_corio(arr, size, tmp));
+        }
+    };
+}
+
 void generate_random_array(int arr[], std::size_t size) {
     for (std::size_t i = 0; i < size; ++i) {
         arr[i] = rand() % size;
@@ -104,6 +120,24 @@ int main() {
         std::cerr << "merge_sort_corio: " << dur << std::endl;
     }
 
+    for (std::size_t threads = 1; threads <= 64; threads *= 2) {
+        for (std::size_t i = 0; i < 3; i++) {
+            std::copy(arr, arr + SIZE, data);
+            auto launch =
+                launch_merge_sort_scaling<corio::WorkStealingPool>(threads);
+            auto dur = marker::measured(launch)(data, SIZE, tmp);
+            std::cerr << "merge_sort_corio (work stealing, " << threads
+                      << " threads): " << dur << std::endl;
+        }
+        for (std::size_t i = 0; i < 3; i++) {
+            std::copy(arr, arr + SIZE, data);
+            auto launch = launch_merge_sort_scaling<asio::thread_pool>(threads);
+            auto dur = marker::measured(launch)(data, SIZE, tmp);
+            std::cerr << "merge_sort_corio (asio strands, " << threads
+                      << " threads): " << dur << std::endl;
+        }
+    }
+
     for (std::size_t i = 0; i < 6; i++) {
         std::copy(arr, arr + SIZE, data);
         auto dur = marker::measured(launch_merge_sort_normal)(data, SIZE, tmp);
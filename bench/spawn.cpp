@@ -21,6 +21,20 @@ void launch_corio_test() {
     ctx.run();
 }
 
+corio::Lazy<void> corio_task_test() {
+    auto ex = co_await corio::this_coro::executor;
+
+    for (std::size_t i = 0; i < n; i++) {
+        corio::spawn(ex, corio_task()).detach();
+    }
+}
+
+void launch_corio_task_test() {
+    asio::io_context ctx{ASIO_CONCURRENCY_HINT_1};
+    corio::spawn_background(ctx.get_executor(), corio_task_test());
+    ctx.run();
+}
+
 asio::awaitable<void> asio_task() { co_return; }
 
 asio::awaitable<void> asio_test() {
@@ -44,6 +58,11 @@ int main() {
         std::cerr << "corio: " << dur << std::endl;
     }
 
+    for (std::size_t i = 0; i < 6; i++) {
+        auto dur = marker::measured(launch_corio_task_test)();
+        std::cerr << "corio (task): " << dur << std::endl;
+    }
+
     for (std::size_t i = 0; i < 6; i++) {
         auto dur = marker::measured(launch_asio_test)();
         std::cerr << "asio: " << dur << std::endl;
@@ -0,0 +1,80 @@
+#include <asio.hpp>
+#include <corio.hpp>
+#include <iostream>
+#include <marker.hpp>
+#include <vector>
+
+constexpr std::size_t n = 10'000'000;
+
+corio::Lazy<void> corio_yield(std::size_t count) {
+    for (std::size_t i = 0; i < count; i++) {
+        co_await corio::this_coro::yield;
+    }
+}
+
+void launch_corio_test() {
+    asio::io_context ctx{ASIO_CONCURRENCY_HINT_1};
+    corio::spawn_background(ctx.get_executor(), corio_yield(n));
+    ctx.run();
+}
+
+// The work stealing pool needs the type-erased executor and synchronization
+#if !defined(CORIO_STATIC_EXECUTOR_TYPE) && !defined(CORIO_SINGLE_THREADED)
+corio::Lazy<void> corio_tasks_test(std::size_t tasks) {
+    std::vector<corio::Task<void>> handles;
+    handles.reserve(tasks);
+    for (std::size_t i = 0; i < tasks; i++) {
+        handles.push_back(co_await corio::spawn(corio_yield(n / tasks)));
+    }
+    for (auto &task : handles) {
+        co_await task;
+    }
+}
+
+auto launch_corio_tasks_test(std::size_t threads) {
+    return [threads]() {
+        corio::WorkStealingPool pool(threads);
+        corio::WorkStealingPool::serial_executor_type serial(
+            pool.get_executor());
+        corio::block_on(serial, corio_tasks_test(threads * 4));
+    };
+}
+#endif
+
+asio::awaitable<void> asio_test() {
+    auto ex = co_await asio::this_coro::executor;
+
+    for (std::size_t i = 0; i < n; i++) {
+        co_await asio::post(ex, asio::deferred);
+    }
+}
+
+void launch_asio_test() {
+    asio::io_context ctx{ASIO_CONCURRENCY_HINT_1};
+    asio::co_spawn(ctx, asio_test(), asio::detached);
+    ctx.run();
+}
+
+int main() {
+    for (std::size_t i = 0; i < 6; i++) {
+        auto dur = marker::measured(launch_asio_test)();
+        std::cerr << "asio: " << dur << std::endl;
+    }
+
+    for (std::size_t i = 0; i < 6; i++) {
+        auto dur = marker::measured(launch_corio_test)();
+        std::cerr << "corio: " << dur << std::endl;
+    }
+
+#if !defined(CORIO_STATIC_EXECUTOR_TYPE) && !defined(CORIO_SINGLE_THREADED)
+    for (std::size_t threads = 1; threads <= 32; threads *= 4) {
+        for (std::size_t i = 0; i < 3; i++) {
+            auto dur = marker::measured(launch_corio_tasks_test(threads))();
+            std::cerr << "corio tasks (" << threads << " threads): " << dur
+                      << std::endl;
+        }
+    }
+#endif
+
+    return 0;
+}
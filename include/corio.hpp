@@ -1,6 +1,7 @@
 #pragma once
 
 #include "corio/any_awaitable.hpp"
+#include "corio/cpu_placement.hpp"
 #include "corio/exceptions.hpp"
 #include "corio/gather.hpp"
 #include "corio/generator.hpp"
@@ -9,6 +10,10 @@
 #include "corio/operators.hpp"
 #include "corio/result.hpp"
 #include "corio/run.hpp"
+#include "corio/runtime.hpp"
 #include "corio/select.hpp"
+#include "corio/serial_executor.hpp"
+#include "corio/sharded_runtime.hpp"
 #include "corio/task.hpp"
 #include "corio/this_coro.hpp"
+#include "corio/work_stealing_pool.hpp"
@@ -1,12 +1,10 @@
 #pragma once
 
+#include "corio/detail/any_awaiter.hpp"
 #include "corio/detail/assert.hpp"
 #include "corio/detail/concepts.hpp"
 #include "corio/detail/type_traits.hpp"
-#include "corio/lazy.hpp"
-#include <memory>
-#include <optional>
-#include <variant>
+#include <type_traits>
 
 namespace corio {
 
@@ -16,24 +14,64 @@ public:
 
     AnyAwaitable() = default;
 
-    template <detail::awaitable Awaitable> AnyAwaitable(Awaitable &&awaitable);
+    template <detail::awaitable Awaitable>
+        requires(!std::is_same_v<std::remove_cvref_t<Awaitable>, AnyAwaitable>)
+    AnyAwaitable(Awaitable &&awaitable);
+
+    AnyAwaitable(AnyAwaitable &&other) noexcept;
+
+    AnyAwaitable &operator=(AnyAwaitable &&other) noexcept;
+
+    ~AnyAwaitable() { reset_(); }
 
-    operator bool() const { return self_.index() != 0; }
+    operator bool() const { return vtable_ != nullptr; }
 
-    auto operator co_await();
+    detail::AnyAwaiter<ReturnType> operator co_await();
 
 private:
-    using Deleter = void (*)(void *);
-    using Invoker = Lazy<ReturnType> (*)(void *self);
+    using Awaiter = detail::AnyAwaiter<ReturnType>;
 
-    template <detail::awaitable Awaitable>
-    static auto make_void_unique_ptr_(Awaitable &&awaitable);
+    struct VTable {
+        // Both are null if the awaitable is not owned
+        void *(*move)(detail::ErasedStorage &storage, void *self) noexcept;
+        void (*destroy)(void *self) noexcept;
+        typename Awaiter::Emplacer emplace_awaiter;
+    };
+
+    template <typename Awaitable>
+    static constexpr VTable owned_vtable_ = {
+        .move = [](detail::ErasedStorage &storage,
+                   void *self) noexcept -> void * {
+            if constexpr (detail::fits_inline_v<Awaitable>) {
+                auto *awaitable = static_cast<Awaitable *>(self);
+                auto *moved = new (&storage) Awaitable(std::move(*awaitable));
+                awaitable->~Awaitable();
+                return moved;
+            } else {
+                return self; // Out-of-line awaitables are moved as a pointer
+            }
+        },
+        .destroy =
+            [](void *self) noexcept {
+                detail::destroy_erased(static_cast<Awaitable *>(self));
+            },
+        .emplace_awaiter = &Awaiter::template emplace<Awaitable>,
+    };
+
+    template <typename Awaitable>
+    static constexpr VTable borrowed_vtable_ = {
+        .move = nullptr,
+        .destroy = nullptr,
+        .emplace_awaiter = &Awaiter::template emplace<Awaitable>,
+    };
+
+    void reset_() noexcept;
 
-    std::variant<std::monostate, std::unique_ptr<void, Deleter>, void *> self_;
-    Invoker invoker_;
-    std::optional<Lazy<ReturnType>> lazy_ = std::nullopt;
+    const VTable *vtable_ = nullptr;
+    void *self_ = nullptr;
+    detail::ErasedStorage storage_;
 };
 
 } // namespace corio
 
-#include "corio/impl/any_awaitable.ipp"
\ No newline at end of file
+#include "corio/impl/any_awaitable.ipp"
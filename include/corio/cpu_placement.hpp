@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace corio {
+
+// Where the threads of a runtime run: thread i is pinned to cpus[i]. Threads
+// on the same NUMA node prefer each other when stealing work, and each one
+// allocates its own structures after being pinned, so that they end up on
+// its node.
+struct CpuPlacement {
+    struct Cpu {
+        int id = -1; // Not pinned if negative
+        int node = 0;
+    };
+
+    std::vector<Cpu> cpus;
+
+    // One thread per CPU the process may run on, grouped by NUMA node. Falls
+    // back to hardware_concurrency() unpinned threads on a single node where
+    // the topology is unknown.
+    static CpuPlacement detect();
+
+    std::size_t thread_count() const noexcept { return cpus.size(); }
+};
+
+namespace detail {
+
+// Pins the calling thread, returning false if it could not be done
+bool pin_this_thread(const CpuPlacement::Cpu &cpu) noexcept;
+
+} // namespace detail
+
+} // namespace corio
+
+#include "corio/impl/cpu_placement.ipp"
@@ -0,0 +1,183 @@
+#pragma once
+
+#include "corio/detail/concepts.hpp"
+#include "corio/detail/frame_allocator.hpp"
+#include "corio/detail/promise_base.hpp"
+#include <coroutine>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace corio::detail {
+
+// Storage for a type-erased object. Small objects are placed inline, larger
+// ones in a block from the per-thread frame pools.
+struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) ErasedStorage {
+    static constexpr std::size_t INLINE_SIZE = 48;
+
+    std::byte data[INLINE_SIZE];
+};
+
+template <typename T>
+inline constexpr bool fits_inline_v =
+    sizeof(T) <= ErasedStorage::INLINE_SIZE &&
+    alignof(T) <= alignof(ErasedStorage) &&
+    std::is_nothrow_move_constructible_v<T>;
+
+template <typename T, typename... Args>
+T *emplace_erased(ErasedStorage &storage, Args &&...args) {
+    static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+                  "Over-aligned types are not supported");
+    if constexpr (fits_inline_v<T>) {
+        return new (&storage) T(std::forward<Args>(args)...);
+    } else {
+        void *block = allocate_pool_frame(sizeof(T));
+        try {
+            return new (block) T(std::forward<Args>(args)...);
+        } catch (...) {
+            deallocate_frame(block, sizeof(T));
+            throw;
+        }
+    }
+}
+
+template <typename T> void destroy_erased(T *ptr) noexcept {
+    ptr->~T();
+    if constexpr (!fits_inline_v<T>) {
+        deallocate_frame(ptr, sizeof(T));
+    }
+}
+
+// The awaiter of an awaitable, or a pointer to the awaitable if it is an
+// awaiter itself
+template <typename Awaitable> auto make_erased_awaiter(Awaitable &awaitable) {
+    if constexpr (awaiter<Awaitable>) {
+        return &awaitable;
+    } else if constexpr (requires { awaitable.operator co_await(); }) {
+        return awaitable.operator co_await();
+    } else {
+        return operator co_await(awaitable);
+    }
+}
+
+template <typename T> decltype(auto) unwrap_erased_awaiter(T &awaiter) {
+    if constexpr (std::is_pointer_v<T>) {
+        return *awaiter;
+    } else {
+        return (awaiter);
+    }
+}
+
+// Calls await_suspend of the awaiter, with the result turned into the handle
+// to transfer to
+template <typename Awaiter, typename Handle>
+std::coroutine_handle<> suspend_erased(Awaiter &awaiter, Handle handle) {
+    using Suspend = decltype(awaiter.await_suspend(handle));
+    if constexpr (std::is_void_v<Suspend>) {
+        awaiter.await_suspend(handle);
+        return std::noop_coroutine();
+    } else if constexpr (std::is_same_v<Suspend, bool>) {
+        if (awaiter.await_suspend(handle)) {
+            return std::noop_coroutine();
+        }
+        return handle;
+    } else {
+        return awaiter.await_suspend(handle);
+    }
+}
+
+// Type-erased awaiter dispatching through a table of thunks. The awaiting
+// coroutine is passed to the thunks as an ErasedHandle, or as a plain
+// coroutine_handle to awaiters that do not take one.
+template <typename ReturnType> class AnyAwaiter {
+public:
+    using Emplacer = void (*)(AnyAwaiter &any_awaiter, void *awaitable);
+
+    AnyAwaiter(Emplacer emplacer, void *awaitable) {
+        emplacer(*this, awaitable);
+    }
+
+    AnyAwaiter(const AnyAwaiter &) = delete;
+    AnyAwaiter &operator=(const AnyAwaiter &) = delete;
+
+    ~AnyAwaiter() { vtable_->destroy(awaiter_); }
+
+    // Builds the awaiter of the awaitable of type `Awaitable` in place
+    template <typename Awaitable>
+    static void emplace(AnyAwaiter &any_awaiter, void *awaitable) {
+        using Awaiter = decltype(make_erased_awaiter(
+            std::declval<Awaitable &>()));
+        any_awaiter.awaiter_ = emplace_erased<Awaiter>(
+            any_awaiter.storage_,
+            make_erased_awaiter(*static_cast<Awaitable *>(awaitable)));
+        any_awaiter.vtable_ = &vtable_for_<Awaiter>;
+    }
+
+public:
+    bool await_ready() { return vtable_->await_ready(awaiter_); }
+
+    template <typename Promise>
+    std::coroutine_handle<>
+    await_suspend(std::coroutine_handle<Promise> handle) {
+        static_assert(std::is_base_of_v<PromiseBase, Promise>,
+                      "AnyAwaitable must be awaited in a corio coroutine");
+        return vtable_->await_suspend(awaiter_,
+                                      ErasedHandle(handle, handle.promise()));
+    }
+
+    ReturnType await_resume() { return vtable_->await_resume(awaiter_); }
+
+private:
+    struct VTable {
+        bool (*await_ready)(void *awaiter);
+        std::coroutine_handle<> (*await_suspend)(void *awaiter,
+                                                 ErasedHandle handle);
+        ReturnType (*await_resume)(void *awaiter);
+        void (*destroy)(void *awaiter);
+    };
+
+    template <typename Awaiter>
+    static constexpr VTable vtable_for_ = {
+        .await_ready =
+            [](void *awaiter) -> bool {
+            auto &self = *static_cast<Awaiter *>(awaiter);
+            return unwrap_erased_awaiter(self).await_ready();
+        },
+        .await_suspend =
+            [](void *awaiter, ErasedHandle handle) -> std::coroutine_handle<> {
+            auto &self = *static_cast<Awaiter *>(awaiter);
+            auto &inner = unwrap_erased_awaiter(self);
+            if constexpr (requires { inner.await_suspend(handle); }) {
+                return suspend_erased(inner, handle);
+            } else {
+                // Templated on the promise type of a typed handle
+                return suspend_erased(inner, std::coroutine_handle<>(handle));
+            }
+        },
+        .await_resume =
+            [](void *awaiter) -> ReturnType {
+            auto &self = *static_cast<Awaiter *>(awaiter);
+            auto &inner = unwrap_erased_awaiter(self);
+            using Result = decltype(inner.await_resume());
+            if constexpr (std::is_void_v<Result> &&
+                          !std::is_void_v<ReturnType>) {
+                inner.await_resume();
+                return std::monostate{};
+            } else {
+                return inner.await_resume();
+            }
+        },
+        .destroy =
+            [](void *awaiter) {
+                destroy_erased(static_cast<Awaiter *>(awaiter));
+            },
+    };
+
+private:
+    const VTable *vtable_ = nullptr;
+    void *awaiter_ = nullptr;
+    ErasedStorage storage_;
+};
+
+} // namespace corio::detail
@@ -2,10 +2,15 @@
 
 #include "corio/detail/concepts.hpp"
 #include "corio/detail/context.hpp"
+#include "corio/detail/frame_allocator.hpp"
+#include "corio/detail/resume_token.hpp"
+#include "corio/detail/this_coro.hpp"
 #include "corio/detail/type_traits.hpp"
 #include "corio/lazy.hpp"
 #include "corio/result.hpp"
 #include <asio.hpp>
+#include <coroutine>
+#include <utility>
 
 namespace corio::detail {
 
@@ -22,14 +27,32 @@ public:
     BasicCollectAwaiter(BasicCollectAwaiter &&) = default;
     BasicCollectAwaiter &operator=(BasicCollectAwaiter &&) = default;
 
-    ~BasicCollectAwaiter() { collector_.cancel(); }
-
 public:
     bool await_ready() const noexcept { return false; }
 
-    template <typename Promise>
-    void await_suspend(std::coroutine_handle<Promise> handle) noexcept {
-        collector_.launch_all_await(awaitables_, handle);
+    template <typename Handle>
+    bool await_suspend(Handle handle) noexcept {
+        // The children touch the collection without synchronization, so
+        // they are launched from the runner of the parent. The parent may
+        // still run on a foreign executor after its last await.
+        TaskContext *ctx = handle.promise().context();
+        if (ctx->runner.running_in_this_thread()) {
+            return collector_.launch_all_await(awaitables_, handle);
+        }
+        ctx->runner.post([this, handle, ctx, ticket = token_.ticket()] {
+            if (!ticket.valid()) {
+                return;
+            }
+            FrameArena::Scope scope(arena_on_this_thread(ctx, ctx->arena));
+            if (ctx->state != nullptr && ctx->state->is_abort_requested()) {
+                ctx->state->abort_parked();
+                return;
+            }
+            if (!collector_.launch_all_await(awaitables_, handle)) {
+                handle.resume();
+            }
+        });
+        return true;
     }
 
     auto await_resume() { return collector_.collect_results(); }
@@ -37,63 +60,126 @@ public:
 private:
     AwaitablesType awaitables_;
     Collector collector_;
+
+    // Guards the parent while it is posted to its runner
+    ResumeToken token_;
 };
 
 class CollectorBase {
-public:
-    void cancel() {
-        if (canceled_ != nullptr)
-            *canceled_ = true;
-    }
+private:
+    class ResumeAwaiter {
+    public:
+        explicit ResumeAwaiter(CollectorBase &collector) noexcept
+            : collector_(collector) {}
+
+        bool await_ready() const noexcept {
+            if (std::exchange(collector_.done_, true)) {
+                return true; // Already resumed
+            }
+            // The parent is still launching the children
+            return collector_.resume_handle_ == nullptr;
+        }
 
-    void resume() {
-        if (resume_handle_ != nullptr) {
-            auto do_resume = [h = resume_handle_, c = canceled_] {
-                bool is_canceled = *c;
-                if (!is_canceled) {
-                    h.resume();
-                }
-            };
-            auto executor = ctx_->runner.get_executor();
-            asio::post(executor, do_resume);
-            resume_handle_ = nullptr;
+        std::coroutine_handle<>
+        await_suspend(std::coroutine_handle<>) const noexcept {
+            return std::exchange(collector_.resume_handle_, nullptr);
         }
-    }
+
+        void await_resume() const noexcept {}
+
+    private:
+        CollectorBase &collector_;
+    };
+
+    class RunnerAwaiter {
+    public:
+        explicit RunnerAwaiter(CollectorBase &collector) noexcept
+            : collector_(collector) {}
+
+        bool await_ready() const noexcept {
+            return collector_.ctx_->runner.running_in_this_thread();
+        }
+
+        template <typename Handle>
+        void
+        await_suspend(Handle handle) const noexcept {
+            post_to_runner(handle, collector_.token_.ticket());
+        }
+
+        void await_resume() const noexcept {}
+
+    private:
+        CollectorBase &collector_;
+    };
+
+public:
+    // Awaited by a child before it touches the state of the collection. The
+    // last await of the child may have completed on a foreign executor, in
+    // which case the child is posted back to the runner of the parent, so
+    // that the children never run concurrently with the parent.
+    RunnerAwaiter back_to_runner() noexcept { return RunnerAwaiter(*this); }
+
+    // Awaited by the child that completes the collection, after
+    // back_to_runner(). The child runs on the runner of the parent by then,
+    // so the parent is resumed by symmetric transfer, leaving the child
+    // suspended until the collector is destroyed.
+    ResumeAwaiter resume() noexcept { return ResumeAwaiter(*this); }
 
 protected:
-    template <typename Promise>
-    void register_handle_(std::coroutine_handle<Promise> h) {
-        resume_handle_ = h;
-        Promise &promise = h.promise();
+    template <typename Handle>
+    void register_context_(Handle h) {
+        auto &promise = h.promise();
         ctx_ = promise.context();
     }
 
+    // Returns false if the children are done already, so that the parent
+    // goes on without suspending unless it is out of budget
+    template <typename Handle>
+    bool suspend_parent_(Handle h) noexcept {
+        if (!done_) {
+            resume_handle_ = h;
+            return true;
+        }
+        if (consume_budget(*ctx_)) {
+            return false;
+        }
+        post_to_runner(h, token_.ticket());
+        return true;
+    }
+
     TaskContext *get_context_() const noexcept { return ctx_; }
 
 private:
     std::coroutine_handle<> resume_handle_ = nullptr;
+    bool done_ = false;
     TaskContext *ctx_;
 
-    std::shared_ptr<bool> canceled_ = std::make_shared<bool>(false);
+    // Guards the parent and the children when they are posted to the runner
+    ResumeToken token_;
 };
 
 template <awaitable_iterable Iterable, typename CollectHandler>
 class BasicIterCollector : public CollectorBase {
 public:
-    template <typename Promise>
-    void launch_all_await(Iterable &iterable,
-                          std::coroutine_handle<Promise> handle) {
-        register_handle_(handle);
+    template <typename Handle>
+    bool launch_all_await(Iterable &iterable, Handle handle) {
+        register_context_(handle);
         handler_.init(iterable);
 
+        std::size_t total = std::size(iterable);
+        frames_.reserve(total);
+        lazies_.reserve(total);
+
         std::size_t no = 0;
         for (auto &awaitable : iterable) {
-            corio::Lazy<void> lazy = handler_.do_co_await(*this, no, awaitable);
+            corio::Lazy<void> lazy =
+                handler_.do_co_await(frames_, *this, no, awaitable);
             lazy.set_context(get_context_());
             lazy.get().resume();
             lazies_.push_back(std::move(lazy)); // Keep lazy alive
             no++;
         }
+        return suspend_parent_(handle);
     }
 
     auto collect_results() { return handler_.collect_results(); }
@@ -101,18 +187,23 @@ public:
 private:
     CollectHandler handler_;
 
+    // Shared block for the frames of the lazies
+    FrameSlab frames_;
     std::vector<corio::Lazy<void>> lazies_;
 };
 
 template <typename Tuple, typename CollectHandler>
 class BasicTupleCollector : public CollectorBase {
 public:
-    template <typename Promise>
-    void launch_all_await(Tuple &tuple, std::coroutine_handle<Promise> handle) {
-        register_handle_(handle);
+    template <typename Handle>
+    bool launch_all_await(Tuple &tuple, Handle handle) {
+        register_context_(handle);
         handler_.init(tuple);
 
+        frames_.reserve(std::tuple_size_v<Tuple>);
+        lazies_.reserve(std::tuple_size_v<Tuple>);
         launch_all_await_impl_(tuple);
+        return suspend_parent_(handle);
     }
 
     auto collect_results() { return handler_.collect_results(); }
@@ -126,9 +217,11 @@ private:
 
             corio::Lazy<void> lazy;
             if constexpr (is_reference_wrapper_v<Awaitable>) {
-                lazy = handler_.template do_co_await<I>(*this, awaitable.get());
+                lazy = handler_.template do_co_await<I>(frames_, *this,
+                                                        awaitable.get());
             } else {
-                lazy = handler_.template do_co_await<I>(*this, awaitable);
+                lazy =
+                    handler_.template do_co_await<I>(frames_, *this, awaitable);
             }
 
             lazy.set_context(get_context_());
@@ -142,6 +235,8 @@ private:
 private:
     CollectHandler handler_;
 
+    // Shared block for the frames of the lazies
+    FrameSlab frames_;
     std::vector<corio::Lazy<void>> lazies_;
 };
 
@@ -1,10 +1,15 @@
 #pragma once
 
+#include "corio/detail/frame_allocator.hpp"
+#include "corio/detail/recycling_allocator.hpp"
+#include "corio/detail/resume_token.hpp"
+#include "corio/detail/task_shared_state.hpp"
 #include "corio/detail/type_traits.hpp"
 #include "corio/result.hpp"
 #include <asio.hpp>
 #include <coroutine>
 #include <memory>
+#include <tuple>
 #include <type_traits>
 
 namespace corio::detail {
@@ -74,38 +79,63 @@ inline bool is_operation_aborted(const asio::error_code &ec, Args &&...) {
     return ec == asio::error::operation_aborted;
 }
 
-template <typename... Args> class CompletionHandler {
+// Turns the arguments of a completion handler into the result of co_await,
+// converting error codes into exceptions
+struct ResultBuilder {
+    template <typename... Args> static auto build(Args &&...args) {
+        return build_result(std::forward<Args>(args)...);
+    }
+};
+
+// Same as above, but returns all the arguments as a tuple and never throws
+struct TupleResultBuilder {
+    template <typename... Args> static auto build(Args &&...args) {
+        using T = std::tuple<std::decay_t<Args>...>;
+        return corio::Result<T>::from_result(T(std::forward<Args>(args)...));
+    }
+};
+
+template <typename Builder, typename... Args> class CompletionHandler {
 public:
-    using ResultType = decltype(build_result(std::declval<Args>()...));
+    using ResultType = decltype(Builder::build(std::declval<Args>()...));
 
     explicit CompletionHandler(std::coroutine_handle<> handle,
-                               asio::cancellation_slot slot, ResultType &result)
-        : handle_(handle), slot_(std::move(slot)), result_(result) {}
+                               asio::cancellation_slot slot, ResultType &result,
+                               ResumeToken::Ticket ticket,
+                               const TaskContext *ctx = nullptr)
+        : handle_(handle), slot_(std::move(slot)), result_(result),
+          ticket_(ticket), ctx_(ctx) {}
 
 public:
     using cancellation_slot_type = asio::cancellation_slot;
 
     cancellation_slot_type get_cancellation_slot() const { return slot_; }
 
-    bool *get_canceled() const { return canceled_.get(); }
+    using allocator_type = RecyclingAllocator<void>;
+
+    allocator_type get_allocator() const noexcept { return {}; }
 
 public:
     void operator()(Args... args) const {
         if (is_operation_aborted(args...)) {
             return;
         }
-        if (*canceled_) {
+        if (!ticket_.valid()) {
             return;
         }
-        result_ = build_result(std::forward<Args>(args)...);
-        handle_.resume();
+        result_ = Builder::build(std::forward<Args>(args)...);
+        // The operation may complete on a foreign executor
+        FrameArena::Scope scope(arena_on_this_thread(ctx_, arena_));
+        resume_task(ctx_, handle_);
     }
 
 private:
     std::coroutine_handle<> handle_;
     asio::cancellation_slot slot_;
     ResultType &result_;
-    std::unique_ptr<bool> canceled_ = std::make_unique<bool>(false);
+    ResumeToken::Ticket ticket_;
+    const TaskContext *ctx_;
+    FrameArena *arena_ = FrameArena::current;
 };
 
 } // namespace corio::detail
\ No newline at end of file
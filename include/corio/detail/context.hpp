@@ -1,16 +1,51 @@
 #pragma once
 
+#include "corio/detail/frame_allocator.hpp"
 #include "corio/detail/serial_runner.hpp"
-#include <mutex>
+#include <cstddef>
 
 namespace corio::detail {
 
+class TaskStateBase;
+
+// Awaits a task may complete without going through its executor before it
+// has to yield to the other tasks there
+inline constexpr std::size_t TASK_BUDGET = 128;
+
 struct TaskContext {
     SerialRunner runner;
 
-    // Fields related to TaskSharedState
-    std::mutex *mu_ptr;
-    SerialRunner *curr_runner_ptr;
+    // The task of the coroutines, if they run in one
+    TaskStateBase *state = nullptr;
+
+    // Arena for the frames of the task, if it owns one
+    FrameArena *arena = nullptr;
+
+    // Awaits left before the task has to yield
+    std::size_t budget = TASK_BUDGET;
 };
 
+// The arena of a task serves only the thread running its runner. A handler
+// on a foreign executor leaves it out, so that the frames it allocates come
+// from the pool of its thread, and the frames of the arena it frees take the
+// remote path.
+inline FrameArena *arena_on_this_thread(const TaskContext *ctx,
+                                        FrameArena *arena) noexcept {
+    if (ctx == nullptr || !ctx->runner.running_in_this_thread()) {
+        return nullptr;
+    }
+    return arena;
+}
+
+// Takes one unit from the budget of the task. If it has run out, returns
+// false and refills it, and the caller must yield to the executor.
+inline bool consume_budget(TaskContext &ctx) noexcept {
+    if (ctx.budget == 0) {
+        ctx.budget = TASK_BUDGET;
+        return false;
+    }
+    ctx.budget--;
+    return true;
+}
+
 } // namespace corio::detail
\ No newline at end of file
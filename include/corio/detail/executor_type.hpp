@@ -0,0 +1,28 @@
+#pragma once
+
+#include <asio.hpp>
+#include <type_traits>
+#include <utility>
+
+// Corio stores and posts to asio::any_io_executor by default, which takes
+// any executor at the cost of type erasure. Defining CORIO_EXECUTOR_TYPE to
+// a concrete executor type, e.g. asio::io_context::executor_type, builds
+// corio for that type alone: runners store it as is and posting to it is
+// inlined. The executor must then run handlers one at a time by itself, as
+// an io_context run by a single thread does, since tasks are not given
+// serial executors of their own.
+#ifndef CORIO_EXECUTOR_TYPE
+#define CORIO_EXECUTOR_TYPE ::asio::any_io_executor
+#else
+#define CORIO_STATIC_EXECUTOR_TYPE
+#endif
+
+namespace corio::detail {
+
+using executor_type = CORIO_EXECUTOR_TYPE;
+
+// The executor type with blocking.never required
+using post_executor_type = std::decay_t<decltype(asio::require(
+    std::declval<const executor_type &>(), asio::execution::blocking.never))>;
+
+} // namespace corio::detail
@@ -0,0 +1,568 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace corio::detail {
+
+// Every coroutine frame is preceded by a header telling how to give the block
+// back, so frames can be released from any thread.
+struct FrameHeader {
+    void (*deallocate)(FrameHeader *header, std::size_t frame_size);
+    void *owner;
+};
+
+static_assert(sizeof(FrameHeader) % __STDCPP_DEFAULT_NEW_ALIGNMENT__ == 0);
+
+inline void *frame_of(FrameHeader *header) { return header + 1; }
+
+inline FrameHeader *header_of(void *frame) {
+    return static_cast<FrameHeader *>(frame) - 1;
+}
+
+inline void deallocate_heap_frame(FrameHeader *header, std::size_t frame_size) {
+    ::operator delete(header, sizeof(FrameHeader) + frame_size);
+}
+
+inline void *allocate_heap_frame(std::size_t frame_size) {
+    void *block = ::operator new(sizeof(FrameHeader) + frame_size);
+    auto *header = static_cast<FrameHeader *>(block);
+    header->deallocate = &deallocate_heap_frame;
+    header->owner = nullptr;
+    return frame_of(header);
+}
+
+// Per-thread size-class freelists for coroutine frames. Blocks released by
+// the owner thread go back to its freelists directly, blocks released by other
+// threads are pushed to a lock-free list that the owner drains on its next
+// cache miss. A pool outlives its thread until all its blocks are released.
+class FramePool {
+public:
+    static constexpr std::size_t MIN_BLOCK_SIZE = 64;
+    static constexpr std::size_t NUM_CLASSES = 7; // 64B ~ 4KB
+    static constexpr std::size_t MAX_BLOCK_SIZE = MIN_BLOCK_SIZE
+                                                  << (NUM_CLASSES - 1);
+    static constexpr std::size_t MAX_CACHED_BYTES = 256 * 1024;
+
+    static FramePool *local() noexcept;
+
+    void *allocate(std::size_t frame_size);
+
+    static void deallocate(FrameHeader *header, std::size_t frame_size);
+
+    static std::size_t size_class_of(std::size_t block_size) noexcept {
+        std::size_t size_class = 0;
+        std::size_t class_size = MIN_BLOCK_SIZE;
+        while (class_size < block_size) {
+            class_size <<= 1;
+            size_class++;
+        }
+        return size_class;
+    }
+
+    static std::size_t class_size_of(std::size_t size_class) noexcept {
+        return MIN_BLOCK_SIZE << size_class;
+    }
+
+private:
+    struct FreeBlock {
+        FreeBlock *next;
+        std::size_t size_class;
+    };
+
+    void push_local_(FreeBlock *block);
+
+    void push_remote_(FreeBlock *block);
+
+    void drain_remote_();
+
+    void retire_();
+
+    void release_all_();
+
+    struct LocalHandle {
+        LocalHandle() : pool(new FramePool) { current = pool; }
+        ~LocalHandle() {
+            current = nullptr;
+            exited = true;
+            pool->retire_();
+        }
+        FramePool *pool;
+    };
+
+    static inline thread_local FramePool *current = nullptr;
+    static inline thread_local bool exited = false;
+
+private:
+    FreeBlock *free_lists_[NUM_CLASSES] = {};
+    std::size_t cached_bytes_ = 0;
+
+    // Blocks handed out and not yet released by the owner thread
+    std::size_t live_blocks_ = 0;
+
+    // Blocks released by other threads, see retire_() for the protocol
+    std::atomic<FreeBlock *> remote_frees_ = nullptr;
+    std::atomic<std::ptrdiff_t> remote_balance_ = 0;
+};
+
+inline FramePool *FramePool::local() noexcept {
+    if (exited) {
+        return nullptr; // The thread is tearing down its thread_locals
+    }
+    thread_local LocalHandle handle;
+    return handle.pool;
+}
+
+inline void *FramePool::allocate(std::size_t frame_size) {
+    std::size_t block_size = sizeof(FrameHeader) + frame_size;
+    if (block_size > MAX_BLOCK_SIZE) {
+        return allocate_heap_frame(frame_size);
+    }
+
+    std::size_t size_class = size_class_of(block_size);
+    if (free_lists_[size_class] == nullptr) {
+        drain_remote_();
+    }
+
+    void *block;
+    if (FreeBlock *free_block = free_lists_[size_class]) {
+        free_lists_[size_class] = free_block->next;
+        cached_bytes_ -= class_size_of(size_class);
+        block = free_block;
+    } else {
+        block = ::operator new(class_size_of(size_class));
+    }
+    live_blocks_++;
+
+    auto *header = static_cast<FrameHeader *>(block);
+    header->deallocate = &FramePool::deallocate;
+    header->owner = this;
+    return frame_of(header);
+}
+
+inline void FramePool::deallocate(FrameHeader *header,
+                                  std::size_t frame_size) {
+    auto *pool = static_cast<FramePool *>(header->owner);
+    auto *block = reinterpret_cast<FreeBlock *>(header);
+    block->size_class = size_class_of(sizeof(FrameHeader) + frame_size);
+    if (pool == current) {
+        pool->live_blocks_--;
+        pool->push_local_(block);
+    } else {
+        pool->push_remote_(block);
+    }
+}
+
+inline void FramePool::push_local_(FreeBlock *block) {
+    std::size_t class_size = class_size_of(block->size_class);
+    if (cached_bytes_ + class_size > MAX_CACHED_BYTES) {
+        ::operator delete(block, class_size);
+        return;
+    }
+    block->next = free_lists_[block->size_class];
+    free_lists_[block->size_class] = block;
+    cached_bytes_ += class_size;
+}
+
+inline void FramePool::push_remote_(FreeBlock *block) {
+    block->next = remote_frees_.load(std::memory_order_relaxed);
+    while (!remote_frees_.compare_exchange_weak(block->next, block,
+                                                std::memory_order_release,
+                                                std::memory_order_relaxed)) {
+    }
+    // Only goes from 1 to 0 after the owner thread has retired the pool
+    if (remote_balance_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        release_all_();
+        delete this;
+    }
+}
+
+inline void FramePool::drain_remote_() {
+    FreeBlock *block =
+        remote_frees_.exchange(nullptr, std::memory_order_acquire);
+    while (block != nullptr) {
+        FreeBlock *next = block->next;
+        push_local_(block);
+        block = next;
+    }
+}
+
+inline void FramePool::retire_() {
+    // Remote releases counted so far make the balance negative. Adding the
+    // blocks still alive from the owner's view leaves exactly the number of
+    // blocks nobody has released yet; whoever brings it to 0 frees the pool.
+    release_all_();
+    std::ptrdiff_t live = static_cast<std::ptrdiff_t>(live_blocks_);
+    if (remote_balance_.fetch_add(live, std::memory_order_acq_rel) + live ==
+        0) {
+        release_all_();
+        delete this;
+    }
+}
+
+inline void FramePool::release_all_() {
+    FreeBlock *block =
+        remote_frees_.exchange(nullptr, std::memory_order_acquire);
+    while (block != nullptr) {
+        FreeBlock *next = block->next;
+        ::operator delete(block, class_size_of(block->size_class));
+        block = next;
+    }
+    for (std::size_t i = 0; i < NUM_CLASSES; i++) {
+        block = free_lists_[i];
+        while (block != nullptr) {
+            FreeBlock *next = block->next;
+            ::operator delete(block, class_size_of(i));
+            block = next;
+        }
+        free_lists_[i] = nullptr;
+    }
+    cached_bytes_ = 0;
+}
+
+// Slab arena owned by a single task. Frames allocated while the task is
+// running are carved out of its chunks and recycled through per-size-class
+// freelists. The task retires the arena when it finishes or is aborted; all
+// chunks are then released at once, as soon as the last frame is gone.
+class alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) FrameArena {
+public:
+    static constexpr std::size_t DEFAULT_CHUNK_SIZE = 4096;
+
+    static FrameArena *create(std::size_t chunk_size = DEFAULT_CHUNK_SIZE);
+
+    void *allocate(std::size_t frame_size);
+
+    static void deallocate(FrameHeader *header, std::size_t frame_size);
+
+    void retire();
+
+    // Routes the frames allocated on this thread to `arena` while alive
+    class Scope {
+    public:
+        explicit Scope(FrameArena *arena) noexcept
+            : prev_(std::exchange(current, arena)) {}
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+        ~Scope() { current = prev_; }
+
+    private:
+        FrameArena *prev_;
+    };
+
+    static inline thread_local FrameArena *current = nullptr;
+
+private:
+    struct Chunk {
+        Chunk *next;
+        std::size_t size;
+    };
+
+    struct FreeBlock {
+        FreeBlock *next;
+        std::size_t size_class;
+    };
+
+    FrameArena(std::size_t chunk_size, std::byte *begin, std::byte *end)
+        : chunk_size_(chunk_size), bump_(begin), end_(end) {}
+
+    void *bump_allocate_(std::size_t block_size);
+
+    void push_remote_(FreeBlock *block);
+
+    void drain_remote_();
+
+    void destroy_();
+
+private:
+    std::size_t chunk_size_;
+    std::byte *bump_;
+    std::byte *end_;
+    Chunk *chunks_ = nullptr;
+
+    FreeBlock *free_lists_[FramePool::NUM_CLASSES] = {};
+
+    // Same protocol as FramePool, with the task in place of the thread
+    std::size_t live_blocks_ = 0;
+    std::atomic<FreeBlock *> remote_frees_ = nullptr;
+    std::atomic<std::ptrdiff_t> remote_balance_ = 0;
+};
+
+inline FrameArena *FrameArena::create(std::size_t chunk_size) {
+    // The first chunk lives in the same allocation as the arena itself
+    void *block = ::operator new(sizeof(FrameArena) + chunk_size);
+    auto *begin = static_cast<std::byte *>(block) + sizeof(FrameArena);
+    return new (block) FrameArena(chunk_size, begin, begin + chunk_size);
+}
+
+inline void *FrameArena::allocate(std::size_t frame_size) {
+    std::size_t block_size = sizeof(FrameHeader) + frame_size;
+    if (block_size > FramePool::MAX_BLOCK_SIZE) {
+        return allocate_heap_frame(frame_size);
+    }
+
+    std::size_t size_class = FramePool::size_class_of(block_size);
+    if (free_lists_[size_class] == nullptr) {
+        drain_remote_();
+    }
+
+    void *block;
+    if (FreeBlock *free_block = free_lists_[size_class]) {
+        free_lists_[size_class] = free_block->next;
+        block = free_block;
+    } else {
+        block = bump_allocate_(FramePool::class_size_of(size_class));
+    }
+    live_blocks_++;
+
+    auto *header = static_cast<FrameHeader *>(block);
+    header->deallocate = &FrameArena::deallocate;
+    header->owner = this;
+    return frame_of(header);
+}
+
+inline void *FrameArena::bump_allocate_(std::size_t block_size) {
+    if (static_cast<std::size_t>(end_ - bump_) < block_size) {
+        std::size_t size = sizeof(Chunk) + std::max(chunk_size_, block_size);
+        auto *chunk = static_cast<Chunk *>(::operator new(size));
+        chunk->next = chunks_;
+        chunk->size = size;
+        chunks_ = chunk;
+        bump_ = reinterpret_cast<std::byte *>(chunk + 1);
+        end_ = reinterpret_cast<std::byte *>(chunk) + size;
+    }
+    void *block = bump_;
+    bump_ += block_size;
+    return block;
+}
+
+inline void FrameArena::deallocate(FrameHeader *header,
+                                   std::size_t frame_size) {
+    auto *arena = static_cast<FrameArena *>(header->owner);
+    auto *block = reinterpret_cast<FreeBlock *>(header);
+    block->size_class =
+        FramePool::size_class_of(sizeof(FrameHeader) + frame_size);
+    if (arena == current) {
+        arena->live_blocks_--;
+        block->next = arena->free_lists_[block->size_class];
+        arena->free_lists_[block->size_class] = block;
+    } else {
+        arena->push_remote_(block);
+    }
+}
+
+inline void FrameArena::push_remote_(FreeBlock *block) {
+    block->next = remote_frees_.load(std::memory_order_relaxed);
+    while (!remote_frees_.compare_exchange_weak(block->next, block,
+                                                std::memory_order_release,
+                                                std::memory_order_relaxed)) {
+    }
+    if (remote_balance_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        destroy_();
+    }
+}
+
+inline void FrameArena::drain_remote_() {
+    FreeBlock *block =
+        remote_frees_.exchange(nullptr, std::memory_order_acquire);
+    while (block != nullptr) {
+        FreeBlock *next = block->next;
+        block->next = free_lists_[block->size_class];
+        free_lists_[block->size_class] = block;
+        block = next;
+    }
+}
+
+inline void FrameArena::retire() {
+    // Frames released from now on take the remote path
+    if (current == this) {
+        current = nullptr;
+    }
+    std::ptrdiff_t live = static_cast<std::ptrdiff_t>(live_blocks_);
+    if (remote_balance_.fetch_add(live, std::memory_order_acq_rel) + live ==
+        0) {
+        destroy_();
+    }
+}
+
+inline void FrameArena::destroy_() {
+    std::size_t first_size = sizeof(FrameArena) + chunk_size_;
+    Chunk *chunk = chunks_;
+    while (chunk != nullptr) {
+        Chunk *next = chunk->next;
+        ::operator delete(chunk, chunk->size);
+        chunk = next;
+    }
+    this->~FrameArena();
+    ::operator delete(static_cast<void *>(this), first_size);
+}
+
+// Allocates from the pool of this thread, ignoring the current task arena
+inline void *allocate_pool_frame(std::size_t frame_size) {
+#ifndef CORIO_DISABLE_FRAME_POOL
+    if (FramePool *pool = FramePool::local()) {
+        return pool->allocate(frame_size);
+    }
+#endif
+    return allocate_heap_frame(frame_size);
+}
+
+inline void *allocate_frame(std::size_t frame_size) {
+    if (FrameArena *arena = FrameArena::current) {
+        return arena->allocate(frame_size);
+    }
+    return allocate_pool_frame(frame_size);
+}
+
+inline void deallocate_frame(void *frame, std::size_t frame_size) noexcept {
+    FrameHeader *header = header_of(frame);
+    header->deallocate(header, frame_size);
+}
+
+// One contiguous block for the frames of a known number of sibling
+// coroutines, e.g. the children of a gather. The block is sized from the
+// first frame, allocated like a frame of its own so that small blocks come
+// from the pool or the task arena, and freed with the last of its frames;
+// frames that do not fit are allocated one by one.
+class FrameSlab {
+public:
+    FrameSlab() noexcept = default;
+
+    FrameSlab(const FrameSlab &) = delete;
+    FrameSlab &operator=(const FrameSlab &) = delete;
+
+    FrameSlab(FrameSlab &&other) noexcept
+        : count_(other.count_), block_(std::exchange(other.block_, nullptr)),
+          bump_(std::exchange(other.bump_, nullptr)),
+          end_(std::exchange(other.end_, nullptr)) {}
+
+    FrameSlab &operator=(FrameSlab &&other) noexcept {
+        std::swap(count_, other.count_);
+        std::swap(block_, other.block_);
+        std::swap(bump_, other.bump_);
+        std::swap(end_, other.end_);
+        return *this;
+    }
+
+    ~FrameSlab() {
+        if (block_ != nullptr) {
+            release_(block_);
+        }
+    }
+
+    void reserve(std::size_t count) noexcept { count_ = count; }
+
+    void *allocate(std::size_t frame_size);
+
+    static void deallocate(FrameHeader *header, std::size_t frame_size);
+
+private:
+    struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) Block {
+        std::atomic<std::size_t> refs; // One per frame, plus the slab's
+        std::size_t size;
+    };
+
+    static std::size_t slot_size_(std::size_t frame_size) noexcept {
+        constexpr std::size_t align = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+        return (sizeof(FrameHeader) + frame_size + align - 1) / align * align;
+    }
+
+    static void release_(Block *block) noexcept;
+
+private:
+    std::size_t count_ = 0;
+    Block *block_ = nullptr;
+    std::byte *bump_ = nullptr;
+    std::byte *end_ = nullptr;
+};
+
+inline void *FrameSlab::allocate(std::size_t frame_size) {
+    std::size_t slot_size = slot_size_(frame_size);
+    if (block_ == nullptr && count_ != 0) {
+        std::size_t size = sizeof(Block) + slot_size * count_;
+        block_ = new (allocate_frame(size)) Block{1, size};
+        bump_ = reinterpret_cast<std::byte *>(block_ + 1);
+        end_ = reinterpret_cast<std::byte *>(block_) + size;
+    }
+    if (static_cast<std::size_t>(end_ - bump_) < slot_size) {
+        return allocate_frame(frame_size);
+    }
+
+    auto *header = reinterpret_cast<FrameHeader *>(bump_);
+    bump_ += slot_size;
+    block_->refs.fetch_add(1, std::memory_order_relaxed);
+    header->deallocate = &FrameSlab::deallocate;
+    header->owner = block_;
+    return frame_of(header);
+}
+
+inline void FrameSlab::deallocate(FrameHeader *header, std::size_t) {
+    release_(static_cast<Block *>(header->owner));
+}
+
+inline void FrameSlab::release_(Block *block) noexcept {
+    if (block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::size_t size = block->size;
+        block->~Block();
+        deallocate_frame(block, size);
+    }
+}
+
+// Frames allocated through a user allocator keep a copy of the allocator in
+// front of their header: [Alloc][FrameHeader][frame].
+struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) FrameChunk {
+    std::byte data[__STDCPP_DEFAULT_NEW_ALIGNMENT__];
+};
+
+template <typename Alloc>
+inline constexpr std::size_t allocator_chunks_v =
+    (sizeof(Alloc) + sizeof(FrameChunk) - 1) / sizeof(FrameChunk);
+
+inline std::size_t frame_chunks(std::size_t frame_size) {
+    return (sizeof(FrameHeader) + frame_size + sizeof(FrameChunk) - 1) /
+           sizeof(FrameChunk);
+}
+
+template <typename Alloc>
+void deallocate_allocator_frame(FrameHeader *header, std::size_t frame_size) {
+    using ChunkAlloc = typename std::allocator_traits<
+        Alloc>::template rebind_alloc<FrameChunk>;
+    using ChunkTraits = std::allocator_traits<ChunkAlloc>;
+
+    auto *stored = static_cast<ChunkAlloc *>(header->owner);
+    ChunkAlloc alloc(std::move(*stored));
+    stored->~ChunkAlloc();
+
+    std::size_t chunks =
+        allocator_chunks_v<ChunkAlloc> + frame_chunks(frame_size);
+    ChunkTraits::deallocate(alloc, reinterpret_cast<FrameChunk *>(stored),
+                            chunks);
+}
+
+template <typename Alloc>
+void *allocate_frame_with(const Alloc &allocator, std::size_t frame_size) {
+    using ChunkAlloc = typename std::allocator_traits<
+        Alloc>::template rebind_alloc<FrameChunk>;
+    using ChunkTraits = std::allocator_traits<ChunkAlloc>;
+    static_assert(alignof(ChunkAlloc) <= alignof(FrameChunk),
+                  "Over-aligned allocators are not supported");
+
+    ChunkAlloc alloc(allocator);
+    std::size_t chunks =
+        allocator_chunks_v<ChunkAlloc> + frame_chunks(frame_size);
+    FrameChunk *block = ChunkTraits::allocate(alloc, chunks);
+
+    auto *stored = new (block) ChunkAlloc(std::move(alloc));
+    auto *header = reinterpret_cast<FrameHeader *>(
+        block + allocator_chunks_v<ChunkAlloc>);
+    header->deallocate = &deallocate_allocator_frame<Alloc>;
+    header->owner = stored;
+    return frame_of(header);
+}
+
+} // namespace corio::detail
@@ -16,8 +16,8 @@ public:
         results_.resize(total);
     }
 
-    corio::Lazy<void> do_co_await(CollectorBase &collector, std::size_t no,
-                                  Awaitable &awaitable) {
+    corio::Lazy<void> do_co_await(FrameSlab &, CollectorBase &collector,
+                                  std::size_t no, Awaitable &awaitable) {
         auto &result = results_[no];
         try {
             if constexpr (std::is_void_v<AwaitableReturn>) {
@@ -32,9 +32,10 @@ public:
                 std::current_exception());
         }
 
+        co_await collector.back_to_runner();
         rest_count_--;
         if (rest_count_ == 0) {
-            collector.resume();
+            co_await collector.resume();
         }
     }
 
@@ -59,7 +60,7 @@ public:
     }
 
     template <std::size_t I, typename Awaitable>
-    corio::Lazy<void> do_co_await(CollectorBase &collector,
+    corio::Lazy<void> do_co_await(FrameSlab &, CollectorBase &collector,
                                   Awaitable &awaitable) {
         using T = awaitable_return_t<Awaitable>;
         auto &result = std::get<I>(results_);
@@ -74,9 +75,10 @@ public:
             result = corio::Result<T>::from_exception(std::current_exception());
         }
 
+        co_await collector.back_to_runner();
         rest_count_--;
         if (rest_count_ == 0) {
-            collector.resume();
+            co_await collector.resume();
         }
     }
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "corio/detail/frame_allocator.hpp"
 #include "corio/detail/promise_base.hpp"
 #include "corio/result.hpp"
 #include <coroutine>
@@ -12,6 +13,13 @@ template <typename T> class Generator;
 namespace corio::detail {
 
 template <typename T> class GeneratorPromise : public PromiseBase {
+public:
+    static void *operator new(std::size_t size) { return allocate_frame(size); }
+
+    static void operator delete(void *ptr, std::size_t size) noexcept {
+        deallocate_frame(ptr, size);
+    }
+
 public:
     corio::Generator<T> get_return_object() {
         return corio::Generator<T>{
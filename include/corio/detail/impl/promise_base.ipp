@@ -14,12 +14,11 @@ Task<detail::awaitable_return_t<Awaitable>> spawn(const Executor &executor,
 namespace corio::detail {
 
 inline ExecutorAwaiter PromiseBase::await_transform(const executor_t &) {
-    auto executor = context_->runner.get_executor();
-    return {.executor = executor};
+    return {.executor = context_->runner.get_executor()};
 }
 
 inline auto PromiseBase::await_transform(const yield_t &) {
-    return asio::post(context_->runner.get_executor(), corio::use_corio);
+    return YieldAwaiter{};
 }
 
 template <typename Rep, typename Period>
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+namespace corio::detail {
+
+// Smart pointer to objects carrying their own reference count, exposed
+// through `add_ref()` and `release()`
+template <typename T> class IntrusivePtr {
+public:
+    IntrusivePtr() noexcept = default;
+
+    IntrusivePtr(std::nullptr_t) noexcept {}
+
+    explicit IntrusivePtr(T *ptr) noexcept : ptr_(ptr) {
+        if (ptr_ != nullptr) {
+            ptr_->add_ref();
+        }
+    }
+
+    IntrusivePtr(const IntrusivePtr &other) noexcept
+        : IntrusivePtr(other.ptr_) {}
+
+    IntrusivePtr(IntrusivePtr &&other) noexcept
+        : ptr_(std::exchange(other.ptr_, nullptr)) {}
+
+    IntrusivePtr &operator=(IntrusivePtr other) noexcept {
+        std::swap(ptr_, other.ptr_);
+        return *this;
+    }
+
+    ~IntrusivePtr() {
+        if (ptr_ != nullptr) {
+            ptr_->release();
+        }
+    }
+
+public:
+    T *get() const noexcept { return ptr_; }
+
+    T *operator->() const noexcept { return ptr_; }
+
+    T &operator*() const noexcept { return *ptr_; }
+
+    explicit operator bool() const noexcept { return ptr_ != nullptr; }
+
+    bool operator==(std::nullptr_t) const noexcept { return ptr_ == nullptr; }
+
+private:
+    T *ptr_ = nullptr;
+};
+
+} // namespace corio::detail
@@ -1,9 +1,11 @@
 #pragma once
 
 #include "corio/detail/assert.hpp"
+#include "corio/detail/frame_allocator.hpp"
 #include "corio/detail/promise_base.hpp"
 #include "corio/result.hpp"
 #include <coroutine>
+#include <memory>
 #include <optional>
 
 namespace corio {
@@ -12,7 +14,47 @@ template <typename T> class Lazy;
 
 namespace corio::detail {
 
+template <typename T> struct TaskStateSlot;
+
 class LazyPromiseBase : public PromiseBase {
+public:
+    static void *operator new(std::size_t size) { return allocate_frame(size); }
+
+    // Coroutines taking `std::allocator_arg_t, Alloc` as leading parameters
+    // allocate their frames through the given allocator
+    template <typename Alloc, typename... Args>
+    static void *operator new(std::size_t size, std::allocator_arg_t,
+                              const Alloc &alloc, const Args &...) {
+        return allocate_frame_with(alloc, size);
+    }
+
+    // Same as above, for member functions and lambdas
+    template <typename This, typename Alloc, typename... Args>
+    static void *operator new(std::size_t size, const This &,
+                              std::allocator_arg_t, const Alloc &alloc,
+                              const Args &...) {
+        return allocate_frame_with(alloc, size);
+    }
+
+    // The children of a collective share one block, the slab is passed
+    // right after the object of the member function
+    template <typename This, typename... Args>
+    static void *operator new(std::size_t size, const This &, FrameSlab &slab,
+                              const Args &...) {
+        return slab.allocate(size);
+    }
+
+    // The entry coroutine of a task shares its allocation with the task state
+    template <typename T, typename... Args>
+    static void *operator new(std::size_t size, TaskStateSlot<T> &slot,
+                              const Args &...) {
+        return slot.allocate(size);
+    }
+
+    static void operator delete(void *ptr, std::size_t size) noexcept {
+        deallocate_frame(ptr, size);
+    }
+
 public:
     std::suspend_always initial_suspend() { return {}; }
     FinalAwaiter final_suspend() noexcept { return {destroy_when_exit_}; }
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+
+namespace corio::detail {
+
+// Intrusive MPSC queue after Dmitry Vyukov's, with a stub node so that pushes
+// never take a lock. Nodes are linked through an atomic `next` member. Only
+// one consumer may pop at a time; callers make sure of it, e.g. by popping
+// only from the handler scheduled by whoever marked the queue as scheduled.
+template <typename Node> class MpscQueue {
+public:
+    MpscQueue() noexcept = default;
+
+    MpscQueue(const MpscQueue &) = delete;
+    MpscQueue &operator=(const MpscQueue &) = delete;
+
+    void push(Node *node) noexcept {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        Node *prev = tail_.exchange(node);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    // Returns null if the queue is empty, or if the next node is being pushed
+    Node *pop() noexcept;
+
+    // Only the stub is left once the last node is popped. May be called
+    // from any thread, e.g. after the consumer has let go of the queue.
+    bool empty() const noexcept { return tail_.load() == &stub_; }
+
+private:
+    Node stub_{};
+    std::atomic<Node *> tail_ = &stub_;
+    Node *head_ = &stub_;
+};
+
+template <typename Node> Node *MpscQueue<Node>::pop() noexcept {
+    Node *head = head_;
+    Node *next = head->next.load(std::memory_order_acquire);
+    if (head == &stub_) {
+        if (next == nullptr) {
+            return nullptr;
+        }
+        head_ = next;
+        head = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+    if (next != nullptr) {
+        head_ = next;
+        return head;
+    }
+    if (head != tail_.load()) {
+        return nullptr;
+    }
+    // Keep a node in the queue while popping its last function
+    push(&stub_);
+    next = head->next.load(std::memory_order_acquire);
+    if (next != nullptr) {
+        head_ = next;
+        return head;
+    }
+    return nullptr;
+}
+
+} // namespace corio::detail
@@ -1,44 +1,58 @@
 #pragma once
 
+#include "corio/detail/assert.hpp"
 #include "corio/detail/completion_handler.hpp"
 #include "corio/detail/type_traits.hpp"
 #include <asio.hpp>
-#include <memory>
+#include <optional>
 #include <utility>
 
 namespace corio::detail {
 
-template <typename Initiation, typename PackedInitArgs, typename... Args>
+template <typename Builder, typename Initiation, typename PackedInitArgs,
+          typename... Args>
 class Operation {
 public:
-    using ResultType = typename CompletionHandler<Args...>::ResultType;
+    using Handler = CompletionHandler<Builder, Args...>;
+    using ResultType = typename Handler::ResultType;
 
     explicit Operation(Initiation initiation, PackedInitArgs init_args)
-        : initiation_(std::move(initiation)), init_args_(std::move(init_args)),
-          signal_(std::make_unique<asio::cancellation_signal>()) {}
+        : initiation_(std::move(initiation)),
+          init_args_(std::move(init_args)) {}
 
 public:
     Operation(const Operation &) = delete;
     Operation &operator=(const Operation &) = delete;
 
-    Operation(Operation &&) = default;
-    Operation &operator=(Operation &&) = default;
+    // The signal lives inline and cannot move, so an operation can only be
+    // moved before it is awaited
+    Operation(Operation &&other)
+        : initiation_(std::move(other.initiation_)),
+          init_args_(std::move(other.init_args_)),
+          token_(std::move(other.token_)), resumed_(other.resumed_),
+          result_(std::move(other.result_)) {
+        CORIO_ASSERT(!other.signal_.has_value(),
+                     "The operation is already awaited");
+    }
+
+    Operation &operator=(Operation &&) = delete;
 
     ~Operation() {
-        if (signal_ && !resumed_) {
+        if (signal_.has_value() && !resumed_) {
+            token_.cancel(); // Also covers non-cancelable operations
             signal_->emit(asio::cancellation_type::all);
-            *cancelled_ = true;
         }
     }
 
 public:
     bool await_ready() const noexcept { return false; }
 
-    template <typename Promise>
-    void await_suspend(std::coroutine_handle<Promise> handle) {
+    template <typename Handle>
+    void await_suspend(Handle handle) {
+        signal_.emplace(); // Pinned in the suspended coroutine frame
         auto completion_handler =
-            CompletionHandler<Args...>(handle, signal_->slot(), result_);
-        cancelled_ = completion_handler.get_canceled();
+            Handler(handle, signal_->slot(), result_, token_.ticket(),
+                    handle.promise().context());
 
         initiate_(std::move(completion_handler));
     }
@@ -54,7 +68,7 @@ public:
     }
 
 private:
-    void initiate_(CompletionHandler<Args...> handler) {
+    void initiate_(Handler handler) {
         std::apply(
             [&](auto &&...args) {
                 std::move(initiation_)(std::move(handler),
@@ -67,9 +81,8 @@ private:
     Initiation initiation_;
     PackedInitArgs init_args_;
 
-    std::unique_ptr<asio::cancellation_signal> signal_;
-    // Used for non-cancelable operations
-    bool *cancelled_ = nullptr;
+    std::optional<asio::cancellation_signal> signal_;
+    ResumeToken token_;
     bool resumed_ = false;
 
     ResultType result_;
@@ -42,6 +42,23 @@ private:
     TaskContext *context_ = nullptr;
 };
 
+// Handle to a corio coroutine whose promise type has been erased. The
+// awaiters of corio take it as well as a typed coroutine_handle, see
+// AnyAwaiter.
+class ErasedHandle {
+public:
+    ErasedHandle(std::coroutine_handle<> handle, PromiseBase &promise) noexcept
+        : handle_(handle), promise_(&promise) {}
+
+    PromiseBase &promise() const noexcept { return *promise_; }
+
+    operator std::coroutine_handle<>() const noexcept { return handle_; }
+
+private:
+    std::coroutine_handle<> handle_;
+    PromiseBase *promise_;
+};
+
 struct FinalAwaiter {
     bool await_ready() noexcept { return ready; }
 
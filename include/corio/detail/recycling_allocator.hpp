@@ -0,0 +1,36 @@
+#pragma once
+
+#include "corio/detail/frame_allocator.hpp"
+#include <cstddef>
+
+namespace corio::detail {
+
+// Allocator recycling memory through the per-thread frame pools. Used for the
+// handlers of asio operations awaited with use_corio, so that a steady-state
+// I/O loop does not reach malloc.
+template <typename T> class RecyclingAllocator {
+public:
+    using value_type = T;
+
+    RecyclingAllocator() noexcept = default;
+
+    template <typename U>
+    RecyclingAllocator(const RecyclingAllocator<U> &) noexcept {}
+
+    T *allocate(std::size_t n) {
+        static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+                      "Over-aligned types are not supported");
+        return static_cast<T *>(allocate_pool_frame(n * sizeof(T)));
+    }
+
+    void deallocate(T *ptr, std::size_t n) noexcept {
+        deallocate_frame(ptr, n * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const RecyclingAllocator<U> &) const noexcept {
+        return true;
+    }
+};
+
+} // namespace corio::detail
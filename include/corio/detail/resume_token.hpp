@@ -0,0 +1,182 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+
+namespace corio::detail {
+
+// Guards a resumption posted to an executor against the awaiter being
+// destroyed before it runs, e.g. because the task has been aborted.
+//
+// Tokens live in pooled slots that are never freed. Cancelling or destroying
+// a token bumps the generation of its slot, so tickets taken before that no
+// longer match and can be checked safely from the posted handler.
+class ResumeToken {
+private:
+    struct Slot {
+        // Atomic even with CORIO_SINGLE_THREADED: slots move between threads
+        // through the free lists, so a stale ticket may be checked while
+        // another thread reuses its slot
+        std::atomic<std::uint64_t> generation = 0;
+        Slot *next_free = nullptr;
+    };
+
+public:
+    class Ticket {
+    public:
+        Ticket() = default;
+
+        bool valid() const noexcept {
+            return slot_ != nullptr &&
+                   slot_->generation.load(std::memory_order_acquire) ==
+                       generation_;
+        }
+
+    private:
+        friend class ResumeToken;
+
+        Ticket(Slot *slot, std::uint64_t generation)
+            : slot_(slot), generation_(generation) {}
+
+        Slot *slot_ = nullptr;
+        std::uint64_t generation_ = 0;
+    };
+
+public:
+    ResumeToken() : slot_(acquire_slot_()) {}
+
+    ResumeToken(const ResumeToken &) = delete;
+    ResumeToken &operator=(const ResumeToken &) = delete;
+
+    ResumeToken(ResumeToken &&other) noexcept
+        : slot_(std::exchange(other.slot_, nullptr)) {}
+
+    ResumeToken &operator=(ResumeToken &&other) noexcept {
+        if (this != &other) {
+            reset_();
+            slot_ = std::exchange(other.slot_, nullptr);
+        }
+        return *this;
+    }
+
+    ~ResumeToken() { reset_(); }
+
+public:
+    // A moved-from token hands out tickets that are never valid
+    Ticket ticket() const noexcept {
+        if (slot_ == nullptr) {
+            return Ticket();
+        }
+        return Ticket(slot_,
+                      slot_->generation.load(std::memory_order_relaxed));
+    }
+
+    // Invalidates all tickets taken so far
+    void cancel() noexcept {
+        if (slot_ != nullptr) {
+            slot_->generation.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+private:
+    static constexpr std::size_t SLOTS_PER_BLOCK = 64;
+
+    struct SlotBlock {
+        SlotBlock *next = nullptr;
+        Slot slots[SLOTS_PER_BLOCK] = {};
+    };
+
+    // Slots freed by threads that have exited, and every block ever
+    // allocated so that the slots stay reachable
+    struct GlobalSlots {
+        std::mutex mu;
+        Slot *free = nullptr;
+        SlotBlock *blocks = nullptr;
+    };
+
+    struct LocalSlots {
+        ~LocalSlots() {
+            exited = true;
+            if (free == nullptr) {
+                return;
+            }
+            Slot *last = free;
+            while (last->next_free != nullptr) {
+                last = last->next_free;
+            }
+            GlobalSlots &global = global_slots_();
+            std::lock_guard<std::mutex> lock(global.mu);
+            last->next_free = global.free;
+            global.free = free;
+        }
+
+        Slot *free = nullptr;
+    };
+
+    static GlobalSlots &global_slots_() {
+        static GlobalSlots global;
+        return global;
+    }
+
+    static LocalSlots *local_slots_() noexcept {
+        if (exited) {
+            return nullptr; // The thread is tearing down its thread_locals
+        }
+        thread_local LocalSlots local;
+        return &local;
+    }
+
+    static Slot *acquire_slot_() {
+        LocalSlots *local = local_slots_();
+        if (local != nullptr && local->free != nullptr) {
+            return std::exchange(local->free, local->free->next_free);
+        }
+
+        GlobalSlots &global = global_slots_();
+        std::lock_guard<std::mutex> lock(global.mu);
+        if (global.free == nullptr) {
+            auto *block = new SlotBlock{.next = global.blocks};
+            global.blocks = block;
+            for (Slot &slot : block->slots) {
+                slot.next_free = global.free;
+                global.free = &slot;
+            }
+        }
+        if (local == nullptr) {
+            return std::exchange(global.free, global.free->next_free);
+        }
+        // Move the whole list to this thread
+        local->free = global.free;
+        global.free = nullptr;
+        return std::exchange(local->free, local->free->next_free);
+    }
+
+    static void release_slot_(Slot *slot) noexcept {
+        if (LocalSlots *local = local_slots_()) {
+            slot->next_free = local->free;
+            local->free = slot;
+            return;
+        }
+        GlobalSlots &global = global_slots_();
+        std::lock_guard<std::mutex> lock(global.mu);
+        slot->next_free = global.free;
+        global.free = slot;
+    }
+
+    void reset_() noexcept {
+        if (slot_ != nullptr) {
+            cancel();
+            release_slot_(std::exchange(slot_, nullptr));
+        }
+    }
+
+    static inline thread_local bool exited = false;
+
+private:
+    Slot *slot_;
+};
+
+} // namespace corio::detail
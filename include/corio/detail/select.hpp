@@ -19,35 +19,47 @@ public:
         // DO NOTHING
     }
 
-    corio::Lazy<void> do_co_await(CollectorBase &collector, std::size_t no,
-                                  Awaitable &awaitable) {
+    corio::Lazy<void> do_co_await(FrameSlab &, CollectorBase &collector,
+                                  std::size_t no, Awaitable &awaitable) {
         using Return = void_to_monostate_t<AwaitableReturn>;
+        bool first = false;
+        std::exception_ptr exception;
         try {
             if constexpr (std::is_void_v<AwaitableReturn>) {
                 co_await awaitable;
+                co_await collector.back_to_runner();
                 if (no_ == -1) {
                     no_ = no;
                     result_ =
                         corio::Result<Return>::from_result(std::monostate{});
-                    collector.resume();
+                    first = true;
                 }
             } else {
                 auto &&r = co_await awaitable;
+                co_await collector.back_to_runner();
                 if (no_ == -1) {
                     no_ = no;
                     result_ = corio::Result<Return>::from_result(
                         std::forward<decltype(r)>(r));
-                    collector.resume();
+                    first = true;
                 }
             }
         } catch (...) {
+            exception = std::current_exception();
+        }
+
+        if (exception != nullptr) {
+            co_await collector.back_to_runner();
             if (no_ == -1) {
                 no_ = no;
-                result_ = corio::Result<Return>::from_exception(
-                    std::current_exception());
-                collector.resume();
+                result_ = corio::Result<Return>::from_exception(exception);
+                first = true;
             }
         }
+
+        if (first) {
+            co_await collector.resume();
+        }
     }
 
     ReturnType collect_results() { return {no_, std::move(result_.result())}; }
@@ -72,32 +84,44 @@ public:
     }
 
     template <std::size_t I, typename Awaitable>
-    corio::Lazy<void> do_co_await(CollectorBase &collector,
+    corio::Lazy<void> do_co_await(FrameSlab &, CollectorBase &collector,
                                   Awaitable &awaitable) {
         using T = awaitable_return_t<Awaitable>;
+        bool first = false;
+        std::exception_ptr exception;
         try {
             if constexpr (std::is_void_v<T>) {
                 co_await awaitable;
+                co_await collector.back_to_runner();
                 if (!result_.has_value()) {
                     result_ = corio::Result<ReturnType>::from_result(
                         ReturnType{std::in_place_index<I>, std::monostate{}});
-                    collector.resume();
+                    first = true;
                 }
             } else {
                 auto &&r = co_await awaitable;
+                co_await collector.back_to_runner();
                 if (!result_.has_value()) {
                     result_ = corio::Result<ReturnType>::from_result(ReturnType{
                         std::in_place_index<I>, std::forward<decltype(r)>(r)});
-                    collector.resume();
+                    first = true;
                 }
             }
         } catch (...) {
+            exception = std::current_exception();
+        }
+
+        if (exception != nullptr) {
+            co_await collector.back_to_runner();
             if (!result_.has_value()) {
-                result_ = corio::Result<ReturnType>::from_exception(
-                    std::current_exception());
-                collector.resume();
+                result_ = corio::Result<ReturnType>::from_exception(exception);
+                first = true;
             }
         }
+
+        if (first) {
+            co_await collector.resume();
+        }
     }
 
     ReturnType collect_results() { return std::move(result_.value().result()); }
@@ -1,70 +1,214 @@
 #pragma once
 
 #include "asio/any_io_executor.hpp"
+#include "corio/detail/executor_type.hpp"
+#include "corio/serial_executor.hpp"
+#include "corio/work_stealing_pool.hpp"
 #include <asio.hpp>
 #include <optional>
-#include <variant>
+#include <type_traits>
+#include <utility>
 
 namespace corio::detail {
 
+#ifndef CORIO_STATIC_EXECUTOR_TYPE
+
+// Executor of a task, resolved once when the runner is created, so that
+// the awaiters posting to it on every suspension neither visit the kinds of
+// serial executors nor copy a type-erased executor
 class SerialRunner {
 public:
     SerialRunner() = default;
 
-    SerialRunner(const asio::any_io_executor &serial_executor)
-        : serial_executor_(serial_executor) {}
+    // Executors kept as is must be serial already. Type-erased ones cannot
+    // tell whether they are running in this thread.
+    template <typename Executor>
+        requires(!std::is_same_v<std::remove_cvref_t<Executor>, SerialRunner>)
+    SerialRunner(const Executor &serial_executor)
+        : SerialRunner(serial_executor, serial_executor) {}
 
     template <typename Executor>
-    SerialRunner(const asio::strand<Executor> &strand) {
-        serial_executor_ = StrandExecutor{strand, strand.get_inner_executor()};
+    SerialRunner(const asio::strand<Executor> &strand)
+        : SerialRunner(strand, strand.get_inner_executor()) {}
+
+    SerialRunner(const WorkStealingPool::serial_executor_type &serial)
+        : SerialRunner(serial, serial.get_inner_executor()) {}
+
+    SerialRunner(const SerialExecutor &serial)
+        : SerialRunner(serial, serial.get_inner_executor()) {}
+
+    operator bool() const { return static_cast<bool>(executor_); }
+
+    const asio::any_io_executor &get_executor() const noexcept {
+        return executor_;
+    }
+
+    const asio::any_io_executor &get_inner_executor() const noexcept {
+        return inner_executor_;
+    }
+
+    // The executor with blocking.never already required, which posts by
+    // executing on it directly
+    const post_executor_type &get_post_executor() const noexcept {
+        return post_executor_;
+    }
+
+    template <typename Function> void post(Function &&function) const {
+        post_executor_.execute(std::forward<Function>(function));
+    }
+
+    // Whether the calling thread runs a handler of this runner. Executors
+    // that cannot tell are taken as not running it.
+    bool running_in_this_thread() const noexcept {
+        return running_in_this_thread_(executor_);
     }
 
-    operator bool() const { return serial_executor_.has_value(); }
-
-    asio::any_io_executor get_executor() const {
-        return std::visit(
-            [](const auto &e) -> asio::any_io_executor {
-                using T = std::decay_t<decltype(e)>;
-                if constexpr (std::is_same_v<T, asio::any_io_executor>) {
-                    return e;
-                } else {
-                    return e.executor;
-                }
-            },
-            serial_executor_.value());
+    // Whether a handler of `post_executor` may run right away instead of
+    // being posted, when called from a handler of a task of this runner.
+    // The handler may run on a foreign executor, e.g. the one the last await
+    // of the task completed on.
+    bool try_run_inline(const post_executor_type &post_executor) const {
+        if (post_executor == post_executor_) {
+            return running_in_this_thread();
+        }
+        using PoolSerialExecutor = WorkStealingPool::serial_executor_type;
+        if (const auto *serial = post_executor.target<PoolSerialExecutor>()) {
+            return serial->try_claim();
+        }
+        return false;
     }
 
-    SerialRunner fork_runner() const {
-        auto inner_ex = get_inner_executor();
-        bool is_serial = inner_ex == get_executor();
+    // Runner for a child task, which keeps the priority of this one unless
+    // `priority` is given
+    SerialRunner
+    fork_runner(std::optional<Priority> priority = std::nullopt) const {
+        bool is_serial = inner_executor_ == executor_;
+#ifdef CORIO_SINGLE_THREADED
+        // The inner executor runs on one thread, so it is serial already
+        is_serial = true;
+#endif
         if (is_serial) {
-            return SerialRunner(inner_ex);
-        } else {
-            return SerialRunner(asio::make_strand(inner_ex));
+            return SerialRunner(inner_executor_, inner_executor_,
+                                inner_running_in_this_thread_,
+                                inner_running_in_this_thread_);
+        }
+        // Tasks on a work stealing pool are serialized natively
+        using PoolExecutor = WorkStealingPool::executor_type;
+        using PoolSerialExecutor = WorkStealingPool::serial_executor_type;
+        if (const auto *pool_ex = inner_executor_.target<PoolExecutor>()) {
+            return SerialRunner(PoolSerialExecutor(
+                *pool_ex, priority.value_or(this->priority())));
+        }
+        return SerialRunner(SerialExecutor(inner_executor_));
+    }
+
+    // Only tasks on a work stealing pool have other priorities than normal
+    Priority priority() const {
+        using PoolSerialExecutor = WorkStealingPool::serial_executor_type;
+        if (const auto *serial = executor_.target<PoolSerialExecutor>()) {
+            return serial->priority();
         }
+        return Priority::normal;
     }
 
-    asio::any_io_executor get_inner_executor() const {
-        return std::visit(
-            [](const auto &e) -> asio::any_io_executor {
-                using T = std::decay_t<decltype(e)>;
-                if constexpr (std::is_same_v<T, asio::any_io_executor>) {
-                    return e;
-                } else {
-                    return e.inner_executor;
-                }
-            },
-            serial_executor_.value());
+private:
+    using RunningProbe = bool (*)(const asio::any_io_executor &) noexcept;
+
+    // Probe for an erased executor holding an `Executor`
+    template <typename Executor>
+    static bool running_as_(const asio::any_io_executor &executor) noexcept {
+        if constexpr (requires(const Executor &ex) {
+                          ex.running_in_this_thread();
+                      }) {
+            const auto *target = executor.target<Executor>();
+            return target != nullptr && target->running_in_this_thread();
+        } else {
+            return false;
+        }
     }
 
 private:
-    struct StrandExecutor {
-        asio::any_io_executor executor;
-        asio::any_io_executor inner_executor;
-    };
+    template <typename Executor, typename InnerExecutor>
+    SerialRunner(const Executor &executor,
+                 const InnerExecutor &inner_executor)
+        : SerialRunner(executor, inner_executor, &running_as_<Executor>,
+                       &running_as_<InnerExecutor>) {}
+
+    SerialRunner(asio::any_io_executor executor,
+                 asio::any_io_executor inner_executor,
+                 RunningProbe running_in_this_thread,
+                 RunningProbe inner_running_in_this_thread)
+        : executor_(std::move(executor)),
+          inner_executor_(std::move(inner_executor)),
+          post_executor_(
+              asio::require(executor_, asio::execution::blocking.never)),
+          running_in_this_thread_(running_in_this_thread),
+          inner_running_in_this_thread_(inner_running_in_this_thread) {}
 
-    using VariantExecutor = std::variant<asio::any_io_executor, StrandExecutor>;
-    std::optional<VariantExecutor> serial_executor_;
+private:
+    asio::any_io_executor executor_;
+    asio::any_io_executor inner_executor_;
+    post_executor_type post_executor_;
+    RunningProbe running_in_this_thread_ = &running_as_<asio::any_io_executor>;
+    RunningProbe inner_running_in_this_thread_ =
+        &running_as_<asio::any_io_executor>;
 };
 
+#else
+
+// Runner storing the executor type configured with CORIO_EXECUTOR_TYPE,
+// which serializes the tasks by itself. Forked tasks share the runner.
+class SerialRunner {
+public:
+    SerialRunner() = default;
+
+    SerialRunner(const executor_type &executor)
+        : executor_(executor),
+          post_executor_(
+              asio::require(executor, asio::execution::blocking.never)) {}
+
+    operator bool() const { return executor_.has_value(); }
+
+    const executor_type &get_executor() const noexcept { return *executor_; }
+
+    const executor_type &get_inner_executor() const noexcept {
+        return *executor_;
+    }
+
+    const post_executor_type &get_post_executor() const noexcept {
+        return *post_executor_;
+    }
+
+    template <typename Function> void post(Function &&function) const {
+        post_executor_->execute(std::forward<Function>(function));
+    }
+
+    bool running_in_this_thread() const noexcept {
+        if constexpr (requires(const executor_type &executor) {
+                          executor.running_in_this_thread();
+                      }) {
+            return executor_->running_in_this_thread();
+        } else {
+            return false;
+        }
+    }
+
+    bool try_run_inline(const post_executor_type &post_executor) const {
+        return post_executor == *post_executor_ && running_in_this_thread();
+    }
+
+    SerialRunner fork_runner(std::optional<Priority> = std::nullopt) const {
+        return *this;
+    }
+
+    Priority priority() const { return Priority::normal; }
+
+private:
+    // Concrete executors need not be default constructible
+    std::optional<executor_type> executor_;
+    std::optional<post_executor_type> post_executor_;
+};
+
+#endif
+
 } // namespace corio::detail
\ No newline at end of file
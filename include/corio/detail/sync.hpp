@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+
+// Defining CORIO_SINGLE_THREADED compiles away the synchronization of the
+// state a task shares with its awaiters and abort handles, for programs
+// whose tasks never interact across threads, e.g. one io_context per thread
+// with every task spawned, awaited, aborted and roaming within its thread.
+// Structures shared by all threads, such as the frame pools, stay
+// synchronized, so such programs may still run several threads.
+
+namespace corio::detail {
+
+#ifndef CORIO_SINGLE_THREADED
+
+using TaskMutex = std::mutex;
+
+template <typename T> using TaskAtomic = std::atomic<T>;
+
+#else
+
+struct NullMutex {
+    void lock() noexcept {}
+
+    bool try_lock() noexcept { return true; }
+
+    void unlock() noexcept {}
+};
+
+using TaskMutex = NullMutex;
+
+// A plain value behind the subset of the std::atomic interface corio uses
+template <typename T> class PlainAtomic {
+public:
+    PlainAtomic() noexcept = default;
+
+    constexpr PlainAtomic(T value) noexcept : value_(value) {}
+
+    PlainAtomic(const PlainAtomic &) = delete;
+    PlainAtomic &operator=(const PlainAtomic &) = delete;
+
+public:
+    T load(std::memory_order = std::memory_order_seq_cst) const noexcept {
+        return value_;
+    }
+
+    void store(T value,
+               std::memory_order = std::memory_order_seq_cst) noexcept {
+        value_ = value;
+    }
+
+    T exchange(T value,
+               std::memory_order = std::memory_order_seq_cst) noexcept {
+        T prev = value_;
+        value_ = value;
+        return prev;
+    }
+
+    T fetch_add(T value,
+                std::memory_order = std::memory_order_seq_cst) noexcept {
+        T prev = value_;
+        value_ += value;
+        return prev;
+    }
+
+    T fetch_sub(T value,
+                std::memory_order = std::memory_order_seq_cst) noexcept {
+        T prev = value_;
+        value_ -= value;
+        return prev;
+    }
+
+    T fetch_or(T value,
+               std::memory_order = std::memory_order_seq_cst) noexcept {
+        T prev = value_;
+        value_ |= value;
+        return prev;
+    }
+
+    bool compare_exchange_strong(
+        T &expected, T desired,
+        std::memory_order = std::memory_order_seq_cst,
+        std::memory_order = std::memory_order_seq_cst) noexcept {
+        if (value_ != expected) {
+            expected = value_;
+            return false;
+        }
+        value_ = desired;
+        return true;
+    }
+
+    bool compare_exchange_weak(
+        T &expected, T desired,
+        std::memory_order order = std::memory_order_seq_cst,
+        std::memory_order failure = std::memory_order_seq_cst) noexcept {
+        return compare_exchange_strong(expected, desired, order, failure);
+    }
+
+private:
+    T value_{};
+};
+
+template <typename T> using TaskAtomic = PlainAtomic<T>;
+
+#endif
+
+} // namespace corio::detail
@@ -2,114 +2,216 @@
 
 #include "corio/detail/assert.hpp"
 #include "corio/detail/context.hpp"
+#include "corio/detail/frame_allocator.hpp"
+#include "corio/detail/intrusive_ptr.hpp"
+#include "corio/detail/resume_token.hpp"
 #include "corio/detail/serial_runner.hpp"
+#include "corio/detail/sync.hpp"
 #include "corio/result.hpp"
 #include <asio.hpp>
+#include <atomic>
 #include <coroutine>
+#include <cstddef>
 #include <exception>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <utility>
 
 namespace corio::detail {
 
-template <typename T>
-class TaskSharedState
-    : public std::enable_shared_from_this<TaskSharedState<T>> {
-public:
-    using super = std::enable_shared_from_this<TaskSharedState>;
+template <typename T> class TaskSharedState;
 
-    explicit TaskSharedState(const SerialRunner &runner)
-        : curr_runner_(runner) {
-        context_.runner = curr_runner_;
-        context_.mu_ptr = &mu_;
-        context_.curr_runner_ptr = &curr_runner_;
+// An awaiter of a finished task to be resumed without a trip through its
+// executor
+struct InlineResume {
+    std::coroutine_handle<> handle;
+    ResumeToken::Ticket ticket;
+    FrameArena *arena = nullptr;
+
+    explicit operator bool() const { return handle != nullptr; }
+};
+
+// Destroys the awaiting coroutine, which must be owned by no one, and
+// transfers control to the awaiter in `next`
+struct ExitToInlineResume {
+    InlineResume next;
+
+    bool await_ready() const noexcept { return false; }
+
+    std::coroutine_handle<>
+    await_suspend(std::coroutine_handle<> handle) noexcept {
+        InlineResume resume = next;
+        handle.destroy(); // Also destroys this awaiter
+        if (!resume.ticket.valid()) {
+            return std::noop_coroutine();
+        }
+        // Restored by the scope of the handler running on this thread
+        FrameArena::current = resume.arena;
+        return resume.handle;
+    }
+
+    void await_resume() const noexcept {}
+};
+
+// Leading parameter of the entry coroutine of a task. Allocating the entry
+// frame constructs the shared state in front of it, so that a task costs one
+// allocation besides the frames of the awaitable itself.
+template <typename T> struct TaskStateSlot {
+    const SerialRunner *runner;
+    TaskSharedState<T> **out;
+    TaskSharedState<T> *state = nullptr;
+
+    void *allocate(std::size_t frame_size);
+};
+
+// The part of the shared state of a task that does not depend on its result
+// type, reachable from the coroutines of the task through their TaskContext.
+//
+// Finishing, awaiting and aborting the task synchronize through an atomic
+// state word. The awaiter publishes `resumer_` by setting AWAITER, and the
+// task takes it over by setting FINISHED; whoever comes second sees the
+// other's bit. Aborting sets ABORTED, which every handler resuming a
+// coroutine of the task checks on its executor, tearing the task down there
+// instead. The mutex guards the runner in `context_`, which the task changes
+// when it roams, against readers from other threads.
+class TaskStateBase {
+protected:
+    TaskStateBase(const SerialRunner &runner,
+                  void (*destroy)(TaskStateBase *state))
+        : destroy_(destroy) {
+        context_.runner = runner;
+        context_.state = this;
     }
 
-    template <typename Executor>
-    explicit TaskSharedState(const Executor &executor)
-        : TaskSharedState(SerialRunner{executor}) {}
+    ~TaskStateBase() { retire_arena(); }
 
 public:
-    std::lock_guard<std::mutex> lock() { return std::lock_guard(mu_); }
+    TaskStateBase(const TaskStateBase &) = delete;
+    TaskStateBase &operator=(const TaskStateBase &) = delete;
 
-    bool is_finished() const { return entry_handle_ == nullptr; }
+public:
+    void add_ref() noexcept { refs_.fetch_add(1, std::memory_order_relaxed); }
 
-    bool is_cancelled() const { return is_finished() && !result_.has_value(); }
+    void release() noexcept {
+        if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            destroy_(this);
+        }
+    }
 
-    void set_result(Result<T> result) {
-        CORIO_ASSERT(!result_.has_value(), "The result is already set");
-        result_ = std::move(result);
+public:
+    bool is_finished() const {
+        return (state_.load(std::memory_order_acquire) & FINISHED) != 0;
     }
 
-    Result<T> &result() {
-        CORIO_ASSERT(result_.has_value(), "The task is not finished");
-        return result_.value();
+    bool is_abort_requested() const {
+        return (state_.load(std::memory_order_relaxed) & ABORTED) != 0;
     }
 
-    void register_resumer(const asio::any_io_executor &await_executor,
+    // Returns false if the task has finished, in which case the awaiter
+    // must not suspend for it. `await_executor` is the post executor of the
+    // runner of the awaiter.
+    bool register_resumer(const post_executor_type &await_executor,
                           const std::coroutine_handle<> &await_handle,
-                          const std::shared_ptr<bool> &canceled) {
+                          ResumeToken::Ticket ticket,
+                          TaskContext *await_context) {
         // This method is called from the executor that awaits the task
-        resumer_ = Resumer{await_executor, await_handle, canceled};
+        unsigned state = state_.load(std::memory_order_acquire);
+        while (true) {
+            if ((state & FINISHED) != 0) {
+                return false;
+            }
+            if ((state & AWAITER) == 0) {
+                break;
+            }
+            // Take the slot back from an awaiter that went away, e.g. the
+            // loser of a select
+            if (state_.compare_exchange_weak(state, state & ~AWAITER,
+                                             std::memory_order_acquire)) {
+                state &= ~AWAITER;
+                break;
+            }
+        }
+        resumer_ = Resumer{await_executor, await_handle, ticket,
+                           FrameArena::current, await_context};
+        while (!state_.compare_exchange_weak(state, state | AWAITER,
+                                             std::memory_order_release,
+                                             std::memory_order_acquire)) {
+            if ((state & FINISHED) != 0) {
+                resumer_ = std::nullopt;
+                return false;
+            }
+        }
+        return true;
     }
 
-    bool request_task_resume() {
+    // Marks the task as finished, after its result is set or its entry
+    // frame destroyed. Returns whether an awaiter is registered, which is
+    // then to be resumed with request_task_resume[_inline]().
+    bool finish() {
         // This method is called from executor that runs the task
-        if (!resumer_.has_value()) {
-            return false;
+        unsigned prev = state_.fetch_or(FINISHED, std::memory_order_acq_rel);
+        return (prev & AWAITER) != 0;
+    }
+
+    bool request_task_resume();
+
+    // Like request_task_resume(), but hands the awaiter back instead of
+    // posting it if it may run right away on this thread
+    InlineResume request_task_resume_inline() {
+        // This method is called from executor that runs the task, so that
+        // its runner cannot change under it
+        if (!resumer_.has_value() ||
+            !context_.runner.try_run_inline(resumer_->await_executor_)) {
+            request_task_resume();
+            return {};
+        }
+        // An awaiter that went away may have taken its context with it
+        if (!resumer_->ticket_.valid()) {
+            resumer_ = std::nullopt;
+            return {};
+        }
+        // The awaiting task is not running, so its context is safe to touch
+        if (!consume_budget(*resumer_->await_context_)) {
+            request_task_resume();
+            return {};
         }
         auto &resumer = resumer_.value();
-        auto do_resume = [h = resumer.await_handle_,
-                          canceled = resumer.canceled_] {
-            if (!*canceled) {
-                h.resume();
-            }
-        };
-        asio::post(resumer.await_executor_, do_resume);
+        InlineResume next{resumer.await_handle_, resumer.ticket_,
+                          resumer.await_arena_};
         resumer_ = std::nullopt;
-        return true;
+        return next;
     }
 
-    bool request_abort() {
-        // This method is called from executor that awaits the task
-        bool is_success_finished = result_.has_value();
-        if (is_success_finished || requested_abort_) {
-            return false;
-        }
-        requested_abort_ = true;
-
-        auto task_executor = curr_runner_.get_executor();
-
-        struct AbortChaser {
-            std::shared_ptr<TaskSharedState> state;
-            asio::any_io_executor prev_task_executor;
-
-            void operator()() {
-                auto lock = state->lock();
-                if (state->entry_handle_ == nullptr) {
-                    return; // The task is already finished
-                }
-                auto task_executor = state->curr_runner_.get_executor();
-                if (task_executor != prev_task_executor) {
-                    // The task is switched to another executor. we need to
-                    // cancel task on the executor the task is running, so we
-                    // post the task to the executor and call this function
-                    // again.
-                    prev_task_executor = task_executor;
-                    asio::post(task_executor, *this);
-                    return;
-                }
-                state->entry_handle_.destroy();
-                state->entry_handle_ = nullptr;
-                state->request_task_resume();
-            }
-        };
+    // Sets ABORTED, so that the task is torn down instead of resumed the next
+    // time one of its coroutines would be. With `wake`, one handler is also
+    // posted to tear it down where it is parked, e.g. in an operation that
+    // may never complete, whose cancellation signal is then emitted.
+    bool request_abort(bool wake = true);
 
-        asio::post(task_executor,
-                   AbortChaser{.state = super::shared_from_this(),
-                               .prev_task_executor = task_executor});
+    // Destroys the task, which must be parked on the executor of the caller
+    void abort_parked() {
+        FrameArena::Scope scope(
+            arena_on_this_thread(&context_, context_.arena));
+        // Holds the last reference once the entry frame is gone
+        IntrusivePtr<TaskStateBase> self(this);
+        entry_handle_.destroy();
+        entry_handle_ = nullptr;
+        retire_arena();
+        if (finish()) {
+            request_task_resume();
+        }
+    }
 
-        return true;
+    // Moves the task to `runner` and posts `resume` there. Posting under the
+    // lock keeps an abort from waking the task on `runner` before it is
+    // queued there.
+    template <typename Function>
+    void roam(const SerialRunner &runner, Function &&resume) {
+        std::lock_guard<TaskMutex> lock(mu_);
+        context_.runner = runner;
+        roams_.fetch_add(1, std::memory_order_relaxed);
+        context_.runner.post(std::forward<Function>(resume));
     }
 
     TaskContext *context() { return &context_; }
@@ -118,20 +220,44 @@ public:
         entry_handle_ = entry_handle;
     }
 
+    void enable_arena(std::size_t chunk_size) {
+        CORIO_ASSERT(context_.arena == nullptr, "The arena is already set");
+        context_.arena = FrameArena::create(chunk_size);
+    }
+
+    void retire_arena() {
+        // The frames still alive keep the arena memory until released
+        if (context_.arena != nullptr) {
+            context_.arena->retire();
+            context_.arena = nullptr;
+        }
+    }
+
 private:
-    std::mutex mu_;
+    TaskAtomic<std::size_t> refs_ = 1; // Held by the entry frame
+    void (*destroy_)(TaskStateBase *state);
+
+    // Bits of `state_`, which is zero while the task runs unawaited
+    static constexpr unsigned FINISHED = 1; // Result set or task cancelled
+    static constexpr unsigned AWAITER = 2;  // `resumer_` set for the task
+    static constexpr unsigned ABORTED = 4;  // Abort requested
+    TaskAtomic<unsigned> state_ = 0;
+
+    TaskMutex mu_;
 
     // For task cancellation
     std::coroutine_handle<> entry_handle_;
-    bool requested_abort_ = false;
-    SerialRunner curr_runner_;
+    // Times the task has roamed, for a wake-up to tell whether the task is
+    // still parked on the executor it was posted to
+    TaskAtomic<std::size_t> roams_ = 0;
 
     // For task awaiting
-    std::optional<corio::Result<T>> result_;
     struct Resumer {
-        asio::any_io_executor await_executor_;
+        post_executor_type await_executor_;
         std::coroutine_handle<> await_handle_;
-        std::shared_ptr<bool> canceled_;
+        ResumeToken::Ticket ticket_;
+        FrameArena *await_arena_;
+        TaskContext *await_context_;
     };
     std::optional<Resumer> resumer_;
 
@@ -139,4 +265,136 @@ private:
     TaskContext context_;
 };
 
+// Resumes a parked coroutine from a handler on the executor of its task,
+// unless the task is to abort, in which case it is torn down instead. The
+// caller must have checked the ticket of the coroutine.
+inline void resume_task(const TaskContext *ctx, std::coroutine_handle<> h) {
+    if (ctx != nullptr && ctx->state != nullptr &&
+        ctx->state->is_abort_requested()) {
+        ctx->state->abort_parked();
+        return;
+    }
+    h.resume();
+}
+
+inline bool TaskStateBase::request_task_resume() {
+    // This method is called from executor that runs the task
+    if (!resumer_.has_value()) {
+        return false;
+    }
+    auto &resumer = resumer_.value();
+    auto do_resume = [h = resumer.await_handle_, ticket = resumer.ticket_,
+                      arena = resumer.await_arena_,
+                      ctx = resumer.await_context_] {
+        if (ticket.valid()) {
+            FrameArena::Scope scope(arena);
+            resume_task(ctx, h);
+        }
+    };
+    // Blocking.never is already required of the executor
+    resumer.await_executor_.execute(std::move(do_resume));
+    resumer_ = std::nullopt;
+    return true;
+}
+
+inline bool TaskStateBase::request_abort(bool wake) {
+    unsigned state = state_.load(std::memory_order_relaxed);
+    do {
+        if ((state & (FINISHED | ABORTED)) != 0) {
+            return false;
+        }
+    } while (!state_.compare_exchange_weak(state, state | ABORTED,
+                                           std::memory_order_relaxed));
+    if (!wake) {
+        return true;
+    }
+
+    std::optional<post_executor_type> task_executor;
+    std::size_t roams;
+    {
+        std::lock_guard<TaskMutex> lock(mu_);
+        task_executor = context_.runner.get_post_executor();
+        roams = roams_.load(std::memory_order_relaxed);
+    }
+
+    // If the task has roamed since, the handler resuming it on the new
+    // executor sees ABORTED, so the wake-up is never re-posted
+    task_executor->execute([state = IntrusivePtr<TaskStateBase>(this),
+                            roams] {
+        if (!state->is_finished() &&
+            state->roams_.load(std::memory_order_relaxed) == roams) {
+            state->abort_parked();
+        }
+    });
+    return true;
+}
+
+// Shared by the entry frame, the Task and its AbortHandles. The entry frame
+// holds one reference until it is destroyed, and the memory of both is given
+// back when the last reference is released.
+template <typename T> class TaskSharedState : public TaskStateBase {
+    explicit TaskSharedState(const SerialRunner &runner)
+        : TaskStateBase(runner, &TaskSharedState::destroy_) {}
+
+    friend struct TaskStateSlot<T>;
+
+public:
+    bool is_cancelled() const { return is_finished() && !result_.has_value(); }
+
+    void set_result(Result<T> result) {
+        CORIO_ASSERT(!result_.has_value(), "The result is already set");
+        result_ = std::move(result);
+    }
+
+    Result<T> &result() {
+        CORIO_ASSERT(result_.has_value(), "The task is not finished");
+        return result_.value();
+    }
+
+private:
+    static void destroy_(TaskStateBase *base) {
+        auto *state = static_cast<TaskSharedState *>(base);
+        void *block = state;
+        std::size_t block_size = state->block_size_;
+        state->~TaskSharedState();
+        deallocate_frame(block, block_size);
+    }
+
+    static void release_frame_(FrameHeader *header, std::size_t) {
+        static_cast<TaskSharedState *>(header->owner)->release();
+    }
+
+private:
+    std::size_t block_size_ = 0;
+    std::optional<corio::Result<T>> result_;
+};
+
+template <typename T>
+void *TaskStateSlot<T>::allocate(std::size_t frame_size) {
+    using State = TaskSharedState<T>;
+    static_assert(alignof(State) <= sizeof(FrameHeader));
+    constexpr std::size_t state_size =
+        (sizeof(State) + sizeof(FrameHeader) - 1) / sizeof(FrameHeader) *
+        sizeof(FrameHeader);
+
+    // Layout: [State][FrameHeader][frame]
+    std::size_t block_size = state_size + sizeof(FrameHeader) + frame_size;
+    // Not from the current arena, as the task may outlive it
+    void *block = allocate_pool_frame(block_size);
+    try {
+        state = new (block) State(*runner);
+    } catch (...) {
+        deallocate_frame(block, block_size);
+        throw;
+    }
+    state->block_size_ = block_size;
+
+    auto *header = reinterpret_cast<FrameHeader *>(
+        static_cast<std::byte *>(block) + state_size);
+    header->deallocate = &State::release_frame_;
+    header->owner = state;
+    *out = state;
+    return frame_of(header);
+}
+
 } // namespace corio::detail
@@ -1,10 +1,11 @@
 #pragma once
 
 #include "corio/detail/context.hpp"
+#include "corio/detail/resume_token.hpp"
 #include "corio/detail/serial_runner.hpp"
+#include "corio/detail/task_shared_state.hpp"
 #include <asio.hpp>
 #include <coroutine>
-#include <mutex>
 #include <optional>
 
 namespace corio {
@@ -22,15 +23,29 @@ struct ExecutorAwaiter {
 
     void await_suspend(std::coroutine_handle<>) const noexcept {}
 
-    asio::any_io_executor await_resume() const noexcept { return executor; }
+    executor_type await_resume() const noexcept { return executor; }
 
-    asio::any_io_executor executor;
+    executor_type executor;
 };
 
 struct yield_t {
     constexpr yield_t() noexcept {}
 };
 
+// Resumes the coroutine from the executor of its task, unless the ticket is
+// no longer valid by then
+template <typename Handle>
+void post_to_runner(Handle handle, ResumeToken::Ticket ticket) {
+    auto &promise = handle.promise();
+    TaskContext *ctx = promise.context();
+    ctx->runner.post([h = handle, ticket, ctx, arena = FrameArena::current]() {
+        if (ticket.valid()) {
+            FrameArena::Scope scope(arena);
+            resume_task(ctx, h);
+        }
+    });
+}
+
 struct YieldAwaiter {
     YieldAwaiter() = default;
 
@@ -41,27 +56,42 @@ struct YieldAwaiter {
 
     bool await_ready() const noexcept { return false; }
 
-    template <typename PromiseType>
-    void await_suspend(std::coroutine_handle<PromiseType> handle) noexcept {
-        PromiseType &promise = handle.promise();
-        auto executor = promise.context()->runner.get_executor();
-        asio::post(executor, [h = handle, c = cancelled]() {
-            bool is_cancelled = *c;
-            if (!is_cancelled) {
-                h.resume();
-            }
-        });
+    template <typename Handle>
+    void await_suspend(Handle handle) noexcept {
+        auto &promise = handle.promise();
+        promise.context()->budget = TASK_BUDGET;
+        post_to_runner(handle, token.ticket());
     }
 
     void await_resume() noexcept {}
 
-    ~YieldAwaiter() {
-        if (cancelled != nullptr) {
-            *cancelled = true;
+    ResumeToken token;
+};
+
+// Yields only once the budget of the task has run out
+struct BudgetAwaiter {
+    BudgetAwaiter() = default;
+
+    BudgetAwaiter(const BudgetAwaiter &) = delete;
+    BudgetAwaiter &operator=(const BudgetAwaiter &) = delete;
+    BudgetAwaiter(BudgetAwaiter &&) = default;
+    BudgetAwaiter &operator=(BudgetAwaiter &&) = default;
+
+    bool await_ready() const noexcept { return false; }
+
+    template <typename Handle>
+    bool await_suspend(Handle handle) noexcept {
+        auto &promise = handle.promise();
+        if (consume_budget(*promise.context())) {
+            return false;
         }
+        post_to_runner(handle, token.ticket());
+        return true;
     }
 
-    std::shared_ptr<bool> cancelled = std::make_shared<bool>(false);
+    void await_resume() noexcept {}
+
+    ResumeToken token;
 };
 
 template <typename Time> struct SleepAwaiter {
@@ -74,14 +104,18 @@ template <typename Time> struct SleepAwaiter {
 
     bool await_ready() const noexcept { return false; }
 
-    template <typename PromiseType>
-    void await_suspend(std::coroutine_handle<PromiseType> handle) noexcept {
-        PromiseType &promise = handle.promise();
-        auto executor = promise.context()->runner.get_executor();
-        timer = asio::steady_timer(executor, expire_time);
-        timer.value().async_wait([h = handle](const asio::error_code &ec) {
-            if (!ec) {
-                h.resume();
+    template <typename Handle>
+    void await_suspend(Handle handle) noexcept {
+        auto &promise = handle.promise();
+        TaskContext *ctx = promise.context();
+        timer = asio::steady_timer(ctx->runner.get_executor(), expire_time);
+        // The ticket covers a handler queued before the timer is cancelled
+        timer.value().async_wait([h = handle, ctx, ticket = token.ticket(),
+                                  arena = FrameArena::current](
+                                     const asio::error_code &ec) {
+            if (!ec && ticket.valid()) {
+                FrameArena::Scope scope(arena);
+                resume_task(ctx, h);
             }
         });
     }
@@ -96,6 +130,7 @@ template <typename Time> struct SleepAwaiter {
 
     Time expire_time;
     std::optional<asio::steady_timer> timer;
+    ResumeToken token;
 };
 
 template <typename Executor> class ExecutorSwitchAwaiter {
@@ -106,22 +141,26 @@ public:
 public:
     bool await_ready() const noexcept { return false; }
 
-    template <typename PromiseType>
-    bool await_suspend(std::coroutine_handle<PromiseType> handle) noexcept {
-        PromiseType &promise = handle.promise();
+    template <typename Handle>
+    bool await_suspend(Handle handle) noexcept {
+        auto &promise = handle.promise();
         TaskContext *ctx = promise.context();
-        auto &old_runner = ctx->runner;
-        if (old_runner.get_executor() == executor_) {
+        if (ctx->runner.get_executor() == executor_) {
             return false;
         }
         auto new_runner = SerialRunner(executor_);
-
-        {
-            std::lock_guard<std::mutex> lock(*(ctx->mu_ptr));
-            *(ctx->curr_runner_ptr) = new_runner;
+        auto resume = [h = handle, ctx, ticket = token_.ticket(),
+                       arena = FrameArena::current]() {
+            if (ticket.valid()) {
+                FrameArena::Scope scope(arena);
+                resume_task(ctx, h);
+            }
+        };
+        if (ctx->state != nullptr) {
+            ctx->state->roam(new_runner, std::move(resume));
+        } else {
             ctx->runner = new_runner;
-            asio::post(new_runner.get_executor(),
-                       [h = handle]() { h.resume(); });
+            ctx->runner.post(std::move(resume));
         }
         return true;
     }
@@ -130,6 +169,7 @@ public:
 
 private:
     Executor executor_;
+    ResumeToken token_;
 };
 
 template <typename T> corio::Lazy<T> await_future(std::future<T> &future) {
@@ -17,9 +17,11 @@ public:
         results_.resize(total);
     }
 
-    corio::Lazy<void> do_co_await(CollectorBase &collector, std::size_t no,
-                                  Awaitable &awaitable) {
+    corio::Lazy<void> do_co_await(FrameSlab &, CollectorBase &collector,
+                                  std::size_t no, Awaitable &awaitable) {
         auto &result = results_[no];
+        bool failed_first = false;
+        std::exception_ptr exception;
         try {
             if constexpr (std::is_void_v<AwaitableReturn>) {
                 co_await awaitable;
@@ -27,15 +29,17 @@ public:
                 result = co_await awaitable;
             }
         } catch (...) {
-            if (first_exception_ == nullptr) {
-                first_exception_ = std::current_exception();
-                collector.resume();
-            }
+            exception = std::current_exception();
         }
 
+        co_await collector.back_to_runner();
+        if (exception != nullptr && first_exception_ == nullptr) {
+            first_exception_ = exception;
+            failed_first = true;
+        }
         rest_count_--;
-        if (rest_count_ == 0) {
-            collector.resume();
+        if (failed_first || rest_count_ == 0) {
+            co_await collector.resume();
         }
     }
 
@@ -66,10 +70,12 @@ public:
     }
 
     template <std::size_t I, typename Awaitable>
-    corio::Lazy<void> do_co_await(CollectorBase &collector,
+    corio::Lazy<void> do_co_await(FrameSlab &, CollectorBase &collector,
                                   Awaitable &awaitable) {
         using T = awaitable_return_t<Awaitable>;
         auto &result = std::get<I>(results_);
+        bool failed_first = false;
+        std::exception_ptr exception;
         try {
             if constexpr (std::is_void_v<T>) {
                 co_await awaitable;
@@ -77,15 +83,17 @@ public:
                 result = co_await awaitable;
             }
         } catch (...) {
-            if (first_exception_ == nullptr) {
-                first_exception_ = std::current_exception();
-                collector.resume();
-            }
+            exception = std::current_exception();
         }
 
+        co_await collector.back_to_runner();
+        if (exception != nullptr && first_exception_ == nullptr) {
+            first_exception_ = exception;
+            failed_first = true;
+        }
         rest_count_--;
-        if (rest_count_ == 0) {
-            collector.resume();
+        if (failed_first || rest_count_ == 0) {
+            co_await collector.resume();
         }
     }
 
@@ -26,9 +26,9 @@ public:
 
     operator bool() const { return handle_ != nullptr; }
 
-    template <typename PromiseType>
+    template <typename Handle>
     std::coroutine_handle<promise_type>
-    chain_coroutine(std::coroutine_handle<PromiseType> caller_handle);
+    chain_coroutine(Handle caller_handle);
 
 public:
     auto operator co_await() noexcept;
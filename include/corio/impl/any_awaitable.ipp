@@ -8,47 +8,58 @@ namespace corio {
 
 template <typename... Return>
 template <detail::awaitable Awaitable>
+    requires(!std::is_same_v<std::remove_cvref_t<Awaitable>,
+                             AnyAwaitable<Return...>>)
 AnyAwaitable<Return...>::AnyAwaitable(Awaitable &&awaitable) {
+    using Self = std::remove_reference_t<Awaitable>;
     if constexpr (std::is_lvalue_reference_v<Awaitable>) {
         // If pass by reference, any awaitable will not take the ownership
         self_ = &awaitable;
+        vtable_ = &borrowed_vtable_<Self>;
     } else {
-        // If pass by value, any awaitable will take the ownership
-        self_ = make_void_unique_ptr_(std::forward<Awaitable>(awaitable));
+        // If pass by value, any awaitable will take the ownership. Small
+        // awaitables are stored inline.
+        self_ = detail::emplace_erased<Self>(storage_, std::move(awaitable));
+        vtable_ = &owned_vtable_<Self>;
     }
-    invoker_ = [](void *self) -> Lazy<ReturnType> {
-        constexpr bool need_monostate =
-            std::is_void_v<detail::awaitable_return_t<Awaitable>> &&
-            !std::is_void_v<ReturnType>;
-
-        auto &self_ref = *reinterpret_cast<Awaitable *>(self);
-        if constexpr (need_monostate) {
-            co_await self_ref;
-            co_return std::monostate{};
-        } else {
-            co_return co_await self_ref;
-        }
-    };
 }
 
 template <typename... Return>
-auto AnyAwaitable<Return...>::operator co_await() {
-    CORIO_ASSERT(self_.index() != 0, "Invalid state");
-    if (auto *self_ptr = std::get_if<void *>(&self_)) {
-        lazy_ = invoker_(*self_ptr);
+AnyAwaitable<Return...>::AnyAwaitable(AnyAwaitable &&other) noexcept {
+    *this = std::move(other);
+}
+
+template <typename... Return>
+AnyAwaitable<Return...> &
+AnyAwaitable<Return...>::operator=(AnyAwaitable &&other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+    reset_();
+    vtable_ = std::exchange(other.vtable_, nullptr);
+    void *self = std::exchange(other.self_, nullptr);
+    if (vtable_ != nullptr && vtable_->move != nullptr) {
+        self_ = vtable_->move(storage_, self);
     } else {
-        auto &self = std::get<std::unique_ptr<void, Deleter>>(self_);
-        lazy_ = invoker_(self.get());
+        self_ = self;
     }
-    return lazy_->operator co_await();
+    return *this;
 }
 
 template <typename... Return>
-template <detail::awaitable Awaitable>
-auto AnyAwaitable<Return...>::make_void_unique_ptr_(Awaitable &&awaitable) {
-    auto deleter = [](void *ptr) { delete reinterpret_cast<Awaitable *>(ptr); };
-    return std::unique_ptr<void, Deleter>(
-        new Awaitable(std::forward<Awaitable>(awaitable)), deleter);
+detail::AnyAwaiter<typename AnyAwaitable<Return...>::ReturnType>
+AnyAwaitable<Return...>::operator co_await() {
+    CORIO_ASSERT(vtable_ != nullptr, "Invalid state");
+    return Awaiter(vtable_->emplace_awaiter, self_);
+}
+
+template <typename... Return>
+void AnyAwaitable<Return...>::reset_() noexcept {
+    if (vtable_ != nullptr && vtable_->destroy != nullptr) {
+        vtable_->destroy(self_);
+    }
+    vtable_ = nullptr;
+    self_ = nullptr;
 }
 
-} // namespace corio
\ No newline at end of file
+} // namespace corio
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "corio/cpu_placement.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace corio {
+
+namespace detail {
+
+// Parses a sysfs CPU list such as "0-3,8-11"
+inline std::vector<int> parse_cpu_list(const std::string &list) {
+    std::vector<int> cpus;
+    std::stringstream ss(list);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        if (range.empty()) {
+            continue;
+        }
+        auto dash = range.find('-');
+        try {
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == std::string::npos
+                           ? first
+                           : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; cpu++) {
+                cpus.push_back(cpu);
+            }
+        } catch (const std::exception &) {
+            return {};
+        }
+    }
+    return cpus;
+}
+
+} // namespace detail
+
+inline CpuPlacement CpuPlacement::detect() {
+    CpuPlacement placement;
+#if defined(__linux__)
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+        std::vector<int> node_of(CPU_SETSIZE, 0);
+        std::error_code ec;
+        std::filesystem::directory_iterator it("/sys/devices/system/node",
+                                               ec);
+        for (; !ec && it != std::filesystem::directory_iterator();
+             it.increment(ec)) {
+            // Entries named node<N>
+            std::string name = it->path().filename().string();
+            if (name.size() <= 4 || name.compare(0, 4, "node") != 0 ||
+                name.find_first_not_of("0123456789", 4) != std::string::npos) {
+                continue;
+            }
+            int node = std::stoi(name.substr(4));
+            std::ifstream file(it->path() / "cpulist");
+            std::string list;
+            std::getline(file, list);
+            for (int cpu : detail::parse_cpu_list(list)) {
+                if (cpu >= 0 && cpu < CPU_SETSIZE) {
+                    node_of[cpu] = node;
+                }
+            }
+        }
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &allowed)) {
+                placement.cpus.push_back(Cpu{cpu, node_of[cpu]});
+            }
+        }
+        std::stable_sort(
+            placement.cpus.begin(), placement.cpus.end(),
+            [](const Cpu &a, const Cpu &b) { return a.node < b.node; });
+    }
+#endif
+    if (placement.cpus.empty()) {
+        std::size_t count =
+            std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+        placement.cpus.resize(count);
+    }
+    return placement;
+}
+
+namespace detail {
+
+inline bool pin_this_thread(const CpuPlacement::Cpu &cpu) noexcept {
+    if (cpu.id < 0) {
+        return true;
+    }
+#if defined(__linux__)
+    if (cpu.id >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu.id, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+} // namespace detail
+
+} // namespace corio
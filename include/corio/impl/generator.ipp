@@ -22,13 +22,12 @@ template <typename T> Generator<T>::~Generator() {
 }
 
 template <typename T>
-template <typename PromiseType>
+template <typename Handle>
 std::coroutine_handle<typename Generator<T>::promise_type>
-Generator<T>::chain_coroutine(
-    std::coroutine_handle<PromiseType> caller_handle) {
+Generator<T>::chain_coroutine(Handle caller_handle) {
     CORIO_ASSERT(handle_, "The handle is null");
     promise_type &promise = handle_.promise();
-    PromiseType &caller_promise = caller_handle.promise();
+    auto &caller_promise = caller_handle.promise();
     promise.set_context(caller_promise.context());
     promise.set_caller_handle(caller_handle);
     return handle_;
@@ -42,9 +41,9 @@ public:
 
     bool await_ready() const { return gen_.is_finished(); }
 
-    template <typename PromiseType>
+    template <typename Handle>
     std::coroutine_handle<>
-    await_suspend(std::coroutine_handle<PromiseType> caller_handle) {
+    await_suspend(Handle caller_handle) {
         return gen_.chain_coroutine(caller_handle);
     }
 
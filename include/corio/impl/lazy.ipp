@@ -72,16 +72,19 @@ template <typename T> inline void Lazy<T>::execute() {
     promise_type &promise = handle_.promise();
     const detail::TaskContext *ctx = promise.context();
     CORIO_ASSERT(ctx != nullptr, "The context is not set");
-    asio::post(ctx->runner.get_executor(), handle_);
+    ctx->runner.post([h = handle_, arena = ctx->arena] {
+        detail::FrameArena::Scope scope(arena);
+        h.resume();
+    });
 }
 
 template <typename T>
-template <typename PromiseType>
+template <typename Handle>
 inline std::coroutine_handle<typename Lazy<T>::promise_type>
-Lazy<T>::chain_coroutine(std::coroutine_handle<PromiseType> caller_handle) {
+Lazy<T>::chain_coroutine(Handle caller_handle) {
     CORIO_ASSERT(handle_, "The handle is null");
     promise_type &promise = handle_.promise();
-    PromiseType &caller_promise = caller_handle.promise();
+    auto &caller_promise = caller_handle.promise();
     promise.set_context(caller_promise.context());
     promise.set_caller_handle(caller_handle);
     return handle_;
@@ -95,9 +98,9 @@ public:
 
     bool await_ready() { return lazy_.is_finished(); }
 
-    template <typename PromiseType>
+    template <typename Handle>
     std::coroutine_handle<typename Lazy<T>::promise_type>
-    await_suspend(std::coroutine_handle<PromiseType> caller_handle) {
+    await_suspend(Handle caller_handle) {
         return lazy_.chain_coroutine(caller_handle);
     }
 
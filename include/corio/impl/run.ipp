@@ -1,59 +1,142 @@
 #pragma once
 
+#include "corio/detail/assert.hpp"
 #include "corio/lazy.hpp"
+#include "corio/result.hpp"
 #include "corio/run.hpp"
 #include "corio/task.hpp"
+#include "corio/work_stealing_pool.hpp"
 #include <asio.hpp>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
 
 namespace corio {
 
 namespace detail {
 
-template <awaitable Awaitable>
-Lazy<void>
-launch_with_future(Awaitable awaitable,
-                   std::promise<awaitable_return_t<Awaitable>> promise) {
+// Where a blocking entry waits for the result of its coroutine. Unlike a
+// promise/future pair, it lives on the stack of the waiting thread.
+template <typename T> class BlockingResult {
+public:
+    void set(Result<T> result) {
+        // Notify under the lock, since the waiter destroys this once woken
+        std::lock_guard<std::mutex> lock(mu_);
+        result_.emplace(std::move(result));
+        cv_.notify_one();
+    }
+
+    T get() {
+        std::unique_lock<std::mutex> lock(mu_);
+        cv_.wait(lock, [this] { return result_.has_value(); });
+        if constexpr (std::is_void_v<T>) {
+            result_->result();
+        } else {
+            return std::move(result_->result());
+        }
+    }
+
+private:
+    std::mutex mu_;
+    std::condition_variable cv_;
+    std::optional<Result<T>> result_;
+};
+
+// Where the single-threaded entry keeps the result of its coroutine. The
+// entry runs the io_context on the calling thread until the result is set.
+template <typename T> class LocalResult {
+public:
+    explicit LocalResult(asio::io_context &context) : context_(context) {}
+
+    void set(Result<T> result) {
+        result_.emplace(std::move(result));
+        context_.stop();
+    }
+
+    T get() {
+        // Keep running while the coroutine waits on other executors
+        auto work = asio::make_work_guard(context_);
+        context_.run();
+        CORIO_ASSERT(result_.has_value(), "The io_context stopped early");
+        if constexpr (std::is_void_v<T>) {
+            result_->result();
+        } else {
+            return std::move(result_->result());
+        }
+    }
+
+private:
+    asio::io_context &context_;
+    std::optional<Result<T>> result_;
+};
+
+template <awaitable Awaitable, typename ResultSlot>
+Lazy<void> launch_with_result(Awaitable awaitable, ResultSlot &result) {
+    using T = awaitable_return_t<Awaitable>;
     try {
-        if constexpr (std::is_void_v<awaitable_return_t<Awaitable>>) {
+        if constexpr (std::is_void_v<T>) {
             co_await awaitable;
-            promise.set_value();
+            result.set(Result<T>::from_result());
         } else {
-            promise.set_value(co_await awaitable);
+            result.set(Result<T>::from_result(co_await awaitable));
         }
     } catch (...) {
-        promise.set_exception(std::current_exception());
+        result.set(Result<T>::from_exception(std::current_exception()));
     }
 }
 
+template <awaitable Awaitable>
+inline awaitable_return_t<Awaitable> run_on_this_thread(Awaitable aw) {
+    // Run on the calling thread instead of handing the work to a thread of
+    // its own. The scheduler keeps its lock, which is uncontended here, since
+    // tasks on other executors still post back to it.
+    asio::io_context context{ASIO_CONCURRENCY_HINT_1};
+    LocalResult<awaitable_return_t<Awaitable>> result(context);
+    spawn_background(context.get_executor(),
+                     launch_with_result(std::move(aw), result));
+    return result.get();
+}
+
 } // namespace detail
 
 template <typename Executor, detail::awaitable Awaitable>
 inline detail::awaitable_return_t<Awaitable> block_on(const Executor &executor,
                                                       Awaitable aw) {
-    using T = detail::awaitable_return_t<Awaitable>;
-    std::promise<T> promise;
-    std::future<T> future = promise.get_future();
-    Task<void> task =
-        spawn(executor,
-              detail::launch_with_future(std::move(aw), std::move(promise)));
-    return future.get();
+    detail::BlockingResult<detail::awaitable_return_t<Awaitable>> result;
+    spawn_background(executor,
+                     detail::launch_with_result(std::move(aw), result));
+    return result.get();
 }
 
+#if !defined(CORIO_STATIC_EXECUTOR_TYPE) && !defined(CORIO_SINGLE_THREADED)
+
 template <detail::awaitable Awaitable>
 inline detail::awaitable_return_t<Awaitable> run(Awaitable aw,
                                                  bool multi_thread) {
-    // Since asio already optimizes for single-threaded use cases, we can just
-    // use the default thread pool.
-    std::size_t thread_count =
-        multi_thread ? std::thread::hardware_concurrency() : 1;
-    asio::thread_pool pool(thread_count);
-    auto executor = pool.get_executor();
     if (multi_thread) {
-        auto serial_executor = asio::make_strand(executor);
+        WorkStealingPool pool(std::thread::hardware_concurrency());
+        WorkStealingPool::serial_executor_type serial_executor(
+            pool.get_executor());
         return block_on(serial_executor, std::move(aw));
-    } else {
-        return block_on(executor, std::move(aw));
     }
+    return detail::run_on_this_thread(std::move(aw));
+}
+
+template <detail::awaitable Awaitable>
+inline detail::awaitable_return_t<Awaitable>
+run(Awaitable aw, const CpuPlacement &placement) {
+    WorkStealingPool pool(placement);
+    WorkStealingPool::serial_executor_type serial_executor(pool.get_executor());
+    return block_on(serial_executor, std::move(aw));
 }
 
+#else
+
+template <detail::awaitable Awaitable>
+inline detail::awaitable_return_t<Awaitable> run(Awaitable aw) {
+    return detail::run_on_this_thread(std::move(aw));
+}
+
+#endif
+
 } // namespace corio
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "corio/run.hpp"
+#include "corio/runtime.hpp"
+#include <algorithm>
+
+namespace corio {
+
+inline Runtime::Runtime(std::size_t thread_count)
+    : Runtime(CpuPlacement{std::vector<CpuPlacement::Cpu>(
+          std::max<std::size_t>(thread_count, 1))}) {}
+
+inline Runtime::Runtime(const CpuPlacement &placement)
+    : placement_(placement) {
+    if (placement_.cpus.empty()) {
+        placement_.cpus.resize(1);
+    }
+}
+
+inline WorkStealingPool::serial_executor_type Runtime::make_serial_executor() {
+    return WorkStealingPool::serial_executor_type(pool_ref_().get_executor());
+}
+
+template <detail::awaitable Awaitable>
+detail::awaitable_return_t<Awaitable> Runtime::block_on(Awaitable aw) {
+    return corio::block_on(make_serial_executor(), std::move(aw));
+}
+
+template <detail::awaitable Awaitable>
+Task<detail::awaitable_return_t<Awaitable>> Runtime::spawn(Awaitable aw) {
+    return corio::spawn(make_serial_executor(), std::move(aw));
+}
+
+template <detail::awaitable Awaitable>
+void Runtime::spawn_background(Awaitable aw) {
+    corio::spawn_background(make_serial_executor(), std::move(aw));
+}
+
+inline WorkStealingPool &Runtime::pool_ref_() {
+    std::call_once(start_, [this] {
+        pool_.emplace(placement_);
+        started_.store(true);
+    });
+    return *pool_;
+}
+
+} // namespace corio
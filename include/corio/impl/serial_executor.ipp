@@ -0,0 +1,160 @@
+#pragma once
+
+#include "corio/detail/frame_allocator.hpp"
+#include "corio/detail/mpsc_queue.hpp"
+#include "corio/serial_executor.hpp"
+#include <type_traits>
+#include <utility>
+
+namespace corio {
+
+// The queue of functions is only popped from by the handler draining it, and
+// there is at most one since the handler is only scheduled by whoever sets
+// `scheduled_`.
+class SerialExecutor::Queue {
+public:
+    struct Node {
+        std::atomic<Node *> next = nullptr;
+        // Runs the function if `invoke` is true, and frees the node
+        void (*complete)(Node *node, bool invoke) = nullptr;
+    };
+
+    explicit Queue(const asio::any_io_executor &inner) : inner_(inner) {}
+
+    ~Queue() {
+        // Functions left when the inner executor dropped the handler
+        while (Node *node = nodes_.pop()) {
+            node->complete(node, false);
+        }
+    }
+
+    const asio::any_io_executor &inner() const noexcept { return inner_; }
+
+    void add_ref() noexcept { refs_.fetch_add(1, std::memory_order_relaxed); }
+
+    void release() noexcept {
+        if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+        }
+    }
+
+    void post(Node *node) {
+        nodes_.push(node);
+        bool idle = false;
+        if (scheduled_.compare_exchange_strong(idle, true)) {
+            schedule_();
+        }
+    }
+
+    static inline thread_local Queue *current = nullptr;
+
+private:
+    // Functions run before giving other handlers a chance
+    static constexpr std::size_t BATCH_SIZE = 32;
+
+    void schedule_() {
+        asio::post(inner_, [self = detail::IntrusivePtr<Queue>(this)] {
+            self->run_();
+        });
+    }
+
+    void run_();
+
+private:
+    std::atomic<std::size_t> refs_ = 0;
+    asio::any_io_executor inner_;
+
+    std::atomic<bool> scheduled_ = false;
+    detail::MpscQueue<Node> nodes_;
+};
+
+inline void SerialExecutor::Queue::run_() {
+    // Restores `current` and reschedules the queue unless it went idle, also
+    // when a function throws, so that the queue is never left scheduled
+    // without a handler, like the invoker of an asio strand
+    struct ExitGuard {
+        Queue *self;
+        Queue *prev;
+        bool idle = false;
+
+        ~ExitGuard() {
+            current = prev;
+            if (!idle) {
+                self->schedule_();
+            }
+        }
+    } guard{this, std::exchange(current, this)};
+
+    for (std::size_t i = 0; i < BATCH_SIZE; i++) {
+        Node *node = nodes_.pop();
+        if (node != nullptr) {
+            node->complete(node, true);
+            continue;
+        }
+        // Go idle, unless a node was pushed before the flag was cleared
+        scheduled_.store(false);
+        bool idle = false;
+        if (nodes_.empty() ||
+            !scheduled_.compare_exchange_strong(idle, true)) {
+            guard.idle = true;
+            return;
+        }
+        // The push may not be linked yet, so come back later
+        break;
+    }
+}
+
+template <typename Function>
+struct SerialExecutor::FunctionNode : SerialExecutor::Queue::Node {
+    explicit FunctionNode(Function function)
+        : Node{nullptr, &FunctionNode::complete},
+          function(std::move(function)) {}
+
+    static void complete(Node *node, bool invoke) {
+        auto *self = static_cast<FunctionNode *>(node);
+        Function function(std::move(self->function));
+        self->~FunctionNode();
+        detail::deallocate_frame(self, sizeof(FunctionNode));
+        if (invoke) {
+            std::move(function)();
+        }
+    }
+
+    Function function;
+};
+
+inline SerialExecutor::SerialExecutor(const asio::any_io_executor &inner)
+    : queue_(new Queue(inner)) {}
+
+inline asio::execution_context &
+SerialExecutor::query(asio::execution::context_t) const noexcept {
+    return asio::query(queue_->inner(), asio::execution::context);
+}
+
+template <typename Function>
+void SerialExecutor::execute(Function &&function) const {
+    using FunctionNodeType = FunctionNode<std::decay_t<Function>>;
+    static_assert(alignof(FunctionNodeType) <=
+                      __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+                  "Over-aligned functions are not supported");
+    void *block = detail::allocate_pool_frame(sizeof(FunctionNodeType));
+    Queue::Node *node;
+    try {
+        node = new (block) FunctionNodeType(std::forward<Function>(function));
+    } catch (...) {
+        detail::deallocate_frame(block, sizeof(FunctionNodeType));
+        throw;
+    }
+    queue_->post(node);
+}
+
+inline const asio::any_io_executor &
+SerialExecutor::get_inner_executor() const noexcept {
+    return queue_->inner();
+}
+
+inline bool SerialExecutor::running_in_this_thread() const noexcept {
+    return Queue::current == queue_.get();
+}
+
+} // namespace corio
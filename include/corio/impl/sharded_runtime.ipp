@@ -0,0 +1,72 @@
+#pragma once
+
+#include "corio/detail/assert.hpp"
+#include "corio/sharded_runtime.hpp"
+#include <algorithm>
+
+namespace corio {
+
+inline ShardedRuntime::ShardedRuntime(std::size_t shard_count)
+    : ShardedRuntime(CpuPlacement{std::vector<CpuPlacement::Cpu>(
+          std::max<std::size_t>(shard_count, 1))}) {}
+
+inline ShardedRuntime::ShardedRuntime(const CpuPlacement &placement) {
+    std::size_t shard_count =
+        std::max<std::size_t>(placement.thread_count(), 1);
+    for (std::size_t i = 0; i < shard_count; i++) {
+        shards_.push_back(std::make_unique<Shard>());
+        shards_.back()->work.emplace(shards_.back()->context.get_executor());
+    }
+    for (std::size_t i = 0; i < shard_count; i++) {
+        CpuPlacement::Cpu cpu;
+        if (i < placement.cpus.size()) {
+            cpu = placement.cpus[i];
+        }
+        shards_[i]->thread = std::thread([this, i, cpu] {
+            detail::pin_this_thread(cpu);
+            current_runtime_ = this;
+            current_shard_ = i;
+            shards_[i]->context.run();
+            current_runtime_ = nullptr;
+        });
+    }
+}
+
+inline ShardedRuntime::~ShardedRuntime() {
+    stop();
+    for (auto &shard : shards_) {
+        if (shard->thread.joinable()) {
+            shard->thread.join();
+        }
+    }
+}
+
+inline ShardedRuntime::executor_type
+ShardedRuntime::get_executor(std::size_t shard) const {
+    CORIO_ASSERT(shard < shards_.size(), "The shard is out of range");
+    return shards_[shard]->context.get_executor();
+}
+
+inline void ShardedRuntime::stop() {
+    for (auto &shard : shards_) {
+        shard->work.reset();
+        shard->context.stop();
+    }
+}
+
+template <detail::awaitable Awaitable>
+Task<detail::awaitable_return_t<Awaitable>> spawn_on(std::size_t shard,
+                                                     Awaitable aw) {
+    ShardedRuntime *runtime = ShardedRuntime::current();
+    CORIO_ASSERT(runtime != nullptr, "Not running on a sharded runtime");
+    return spawn(runtime->get_executor(shard), std::move(aw));
+}
+
+template <detail::awaitable Awaitable>
+void spawn_background_on(std::size_t shard, Awaitable aw) {
+    ShardedRuntime *runtime = ShardedRuntime::current();
+    CORIO_ASSERT(runtime != nullptr, "Not running on a sharded runtime");
+    spawn_background(runtime->get_executor(shard), std::move(aw));
+}
+
+} // namespace corio
@@ -3,17 +3,19 @@
 #include "corio/detail/concepts.hpp"
 #include "corio/detail/serial_runner.hpp"
 #include "corio/detail/task_shared_state.hpp"
+#include "corio/detail/this_coro.hpp"
 #include "corio/lazy.hpp"
 #include "corio/task.hpp"
 #include <memory>
+#include <optional>
 
 namespace corio {
 
 namespace detail {
 
-template <detail::awaitable Awaitable, typename T>
-Lazy<void> launch_task(Awaitable aw,
-                       std::shared_ptr<detail::TaskSharedState<T>> state) {
+template <typename T, detail::awaitable Awaitable>
+Lazy<void> launch_task(TaskStateSlot<T> slot, Awaitable aw) {
+    TaskSharedState<T> *state = slot.state;
     Result<T> result;
     try {
         if constexpr (std::is_void_v<T>) {
@@ -27,18 +29,20 @@ Lazy<void> launch_task(Awaitable aw,
         result = Result<T>::from_exception(std::current_exception());
     }
 
-    {
-        auto lock = state->lock();
-        state->set_result(std::move(result));
-        state->request_task_resume();
-        state->set_entry_handle(nullptr);
+    state->set_result(std::move(result));
+    state->set_entry_handle(nullptr);
+    state->retire_arena();
+    if (state->finish()) {
+        InlineResume next = state->request_task_resume_inline();
+        if (next) {
+            co_await ExitToInlineResume{next};
+        }
     }
 }
 
-template <detail::awaitable Awaitable, typename T>
-Lazy<void>
-launch_task_background(Awaitable aw,
-                       std::unique_ptr<detail::TaskSharedState<T>> state) {
+template <typename T, detail::awaitable Awaitable>
+Lazy<void> launch_task_background(TaskStateSlot<T>, Awaitable aw) {
+    // The state lives as long as this frame
     co_await aw;
 }
 
@@ -47,8 +51,28 @@ launch_task_background(Awaitable aw,
 template <typename T>
 template <detail::awaitable Awaitable>
 Task<T>::Task(Awaitable aw, const detail::SerialRunner &runner) {
-    state_ = std::make_shared<SharedState>(runner);
-    Lazy<void> entry = detail::launch_task(std::move(aw), state_);
+    launch_(std::move(aw), runner, std::nullopt);
+}
+
+template <typename T>
+template <detail::awaitable Awaitable>
+Task<T>::Task(Awaitable aw, const detail::SerialRunner &runner,
+              use_arena_t arena) {
+    launch_(std::move(aw), runner, arena);
+}
+
+template <typename T>
+template <detail::awaitable Awaitable>
+void Task<T>::launch_(Awaitable aw, const detail::SerialRunner &runner,
+                      std::optional<use_arena_t> arena) {
+    SharedState *state = nullptr;
+    Lazy<void> entry = detail::launch_task(
+        detail::TaskStateSlot<T>{.runner = &runner, .out = &state},
+        std::move(aw));
+    state_ = detail::IntrusivePtr<SharedState>(state);
+    if (arena.has_value()) {
+        state_->enable_arena(arena->chunk_size);
+    }
 
     auto entry_handle = entry.get();
     state_->set_entry_handle(entry_handle);
@@ -68,36 +92,30 @@ template <typename T> Task<T> &Task<T>::operator=(Task &&other) noexcept {
 }
 
 template <typename T> Task<T>::~Task() {
-    if (state_ != nullptr) {
-        auto lock = state_->lock();
-        if (!state_->is_finished()) {
-            state_->request_abort();
-        }
+    if (state_ != nullptr && !state_->is_finished()) {
+        state_->request_abort();
     }
 }
 
 template <typename T> bool Task<T>::is_finished() const {
     CORIO_ASSERT(state_ != nullptr, "Task is not initialized");
-    auto lock = state_->lock();
     return state_->is_finished();
 }
 
 template <typename T> bool Task<T>::is_cancelled() const {
     CORIO_ASSERT(state_ != nullptr, "Task is not initialized");
-    auto lock = state_->lock();
     return state_->is_cancelled();
 }
 
 template <typename T> Result<T> Task<T>::get_result() {
     CORIO_ASSERT(state_ != nullptr, "Task is not initialized");
-    auto lock = state_->lock();
+    CORIO_ASSERT(state_->is_finished(), "The task is not finished");
     return std::move(state_->result());
 }
 
-template <typename T> bool Task<T>::abort() {
+template <typename T> bool Task<T>::abort(AbortMode mode) {
     CORIO_ASSERT(state_ != nullptr, "Task is not initialized");
-    auto lock = state_->lock();
-    return state_->request_abort();
+    return state_->request_abort(mode == AbortMode::immediate);
 }
 
 template <typename T> AbortHandle<T> Task<T>::get_abort_handle() {
@@ -119,41 +137,40 @@ template <typename T> class TaskAwaiter {
 public:
     using SharedState = typename Task<T>::SharedState;
 
-    explicit TaskAwaiter(const std::shared_ptr<SharedState> &state)
+    explicit TaskAwaiter(const IntrusivePtr<SharedState> &state)
         : state_(state) {}
 
     bool await_ready() const noexcept { return false; }
 
-    template <typename Promise>
-    bool await_suspend(std::coroutine_handle<Promise> handle) noexcept {
-        auto lock = state_->lock();
+    template <typename Handle>
+    bool await_suspend(Handle handle) noexcept {
+        auto &promise = handle.promise();
 
-        if (state_->is_finished()) {
-            return false;
+        if (!state_->is_finished()) {
+            TaskContext *ctx = promise.context();
+            if (state_->register_resumer(ctx->runner.get_post_executor(),
+                                         handle, token_.ticket(), ctx)) {
+                return true;
+            }
         }
 
-        Promise &promise = handle.promise();
-        auto executor = promise.context()->runner.get_executor();
-
-        state_->register_resumer(executor, handle, canceled_);
-
+        // Ready, but the other tasks may be waiting for their turn
+        if (consume_budget(*promise.context())) {
+            return false;
+        }
+        post_to_runner(handle, token_.ticket());
         return true;
     }
 
     T await_resume() {
-        corio::Result<T> result;
-        {
-            auto lock = state_->lock();
-
-            CORIO_ASSERT(state_->is_finished(), "The task is not finished");
-
-            if (state_->is_cancelled()) {
-                throw CancellationError("The task is canceled");
-            }
+        CORIO_ASSERT(state_->is_finished(), "The task is not finished");
 
-            result = std::move(state_->result());
+        if (state_->is_cancelled()) {
+            throw CancellationError("The task is canceled");
         }
 
+        corio::Result<T> result = std::move(state_->result());
+
         if constexpr (std::is_void_v<T>) {
             result.result();
             return;
@@ -162,15 +179,9 @@ public:
         }
     }
 
-    ~TaskAwaiter() {
-        if (canceled_ != nullptr) {
-            *canceled_ = true;
-        }
-    }
-
 private:
-    std::shared_ptr<SharedState> state_;
-    std::shared_ptr<bool> canceled_ = std::make_shared<bool>(false);
+    IntrusivePtr<SharedState> state_;
+    ResumeToken token_;
 };
 
 } // namespace detail
@@ -180,72 +191,86 @@ template <typename T> auto Task<T>::operator co_await() const {
     return detail::TaskAwaiter<T>(state_);
 }
 
-template <typename T> bool AbortHandle<T>::abort() {
-    auto lock = state_->lock();
-    return state_->request_abort();
+template <typename T> bool AbortHandle<T>::abort(AbortMode mode) {
+    return state_->request_abort(mode == AbortMode::immediate);
 }
 
 namespace detail {
 
 template <detail::awaitable Awaitable> class ForkTaskAwaiter {
 public:
-    explicit ForkTaskAwaiter(Awaitable aw) : aw_(std::move(aw)) {}
+    explicit ForkTaskAwaiter(Awaitable aw,
+                             std::optional<use_arena_t> arena = std::nullopt,
+                             std::optional<Priority> priority = std::nullopt)
+        : aw_(std::move(aw)), arena_(arena), priority_(priority) {}
 
     bool await_ready() const noexcept { return false; }
 
-    template <typename Promise>
-    bool await_suspend(std::coroutine_handle<Promise> handle) {
-        Promise &promise = handle.promise();
-        forked_runner_ = promise.context()->runner.fork_runner();
+    template <typename Handle>
+    bool await_suspend(Handle handle) {
+        auto &promise = handle.promise();
+        forked_runner_ = promise.context()->runner.fork_runner(priority_);
         return false;
     }
 
     auto await_resume() {
         using T = detail::awaitable_return_t<Awaitable>;
+        if (arena_.has_value()) {
+            return Task<T>(std::move(aw_), forked_runner_, arena_.value());
+        }
         return Task<T>(std::move(aw_), forked_runner_);
     }
 
 private:
     Awaitable aw_;
+    std::optional<use_arena_t> arena_;
+    std::optional<Priority> priority_;
     SerialRunner forked_runner_;
 };
 
 template <awaitable Awaitable>
-void spawn_background_impl(Awaitable aw, const detail::SerialRunner &runner) {
+void spawn_background_impl(Awaitable aw, const detail::SerialRunner &runner,
+                           std::optional<use_arena_t> arena = std::nullopt) {
     using T = detail::awaitable_return_t<Awaitable>;
-    auto state = std::make_unique<detail::TaskSharedState<T>>(runner);
-    auto state_raw = state.get();
-    Lazy<void> entry =
-        detail::launch_task_background(std::move(aw), std::move(state));
+    TaskSharedState<T> *state = nullptr;
+    Lazy<void> entry = detail::launch_task_background(
+        TaskStateSlot<T>{.runner = &runner, .out = &state}, std::move(aw));
+    if (arena.has_value()) {
+        state->enable_arena(arena->chunk_size);
+    }
 
     auto entry_handle = entry.get();
     entry_handle.promise().set_destroy_when_exit(true);
 
-    entry.set_context(state_raw->context());
+    entry.set_context(state->context());
     entry.execute();
     entry.release();
 }
 
 template <detail::awaitable Awaitable> class ForkTaskBackgroundAwaiter {
 public:
-    explicit ForkTaskBackgroundAwaiter(Awaitable aw) : aw_(std::move(aw)) {}
+    explicit ForkTaskBackgroundAwaiter(
+        Awaitable aw, std::optional<use_arena_t> arena = std::nullopt,
+        std::optional<Priority> priority = std::nullopt)
+        : aw_(std::move(aw)), arena_(arena), priority_(priority) {}
 
     bool await_ready() const noexcept { return false; }
 
-    template <typename Promise>
-    bool await_suspend(std::coroutine_handle<Promise> handle) {
-        Promise &promise = handle.promise();
-        forked_runner_ = promise.context()->runner.fork_runner();
+    template <typename Handle>
+    bool await_suspend(Handle handle) {
+        auto &promise = handle.promise();
+        forked_runner_ = promise.context()->runner.fork_runner(priority_);
         return false;
     }
 
     void await_resume() {
-        using T = detail::awaitable_return_t<Awaitable>;
-        spawn_background_impl(std::move(aw_), forked_runner_);
+        spawn_background_impl(std::move(aw_), forked_runner_, arena_);
     }
 
 private:
     Awaitable aw_;
+    std::optional<use_arena_t> arena_;
+    std::optional<Priority> priority_;
     SerialRunner forked_runner_;
 };
 
@@ -273,4 +298,44 @@ Lazy<void> spawn_background(Awaitable aw) {
     co_await detail::ForkTaskBackgroundAwaiter<Awaitable>(std::move(aw));
 }
 
+template <detail::awaitable Awaitable>
+Lazy<Task<detail::awaitable_return_t<Awaitable>>> spawn(Awaitable aw,
+                                                        use_arena_t arena) {
+    co_return co_await detail::ForkTaskAwaiter<Awaitable>(std::move(aw),
+                                                          arena);
+}
+
+template <typename Executor, detail::awaitable Awaitable>
+Task<detail::awaitable_return_t<Awaitable>>
+spawn(const Executor &executor, Awaitable aw, use_arena_t arena) {
+    return Task<detail::awaitable_return_t<Awaitable>>(
+        std::move(aw), detail::SerialRunner{executor}, arena);
+}
+
+template <detail::awaitable Awaitable>
+Lazy<void> spawn_background(Awaitable aw, use_arena_t arena) {
+    co_await detail::ForkTaskBackgroundAwaiter<Awaitable>(std::move(aw),
+                                                          arena);
+}
+
+template <typename Executor, detail::awaitable Awaitable>
+void spawn_background(const Executor &executor, Awaitable aw,
+                      use_arena_t arena) {
+    detail::spawn_background_impl(std::move(aw),
+                                  detail::SerialRunner{executor}, arena);
+}
+
+template <detail::awaitable Awaitable>
+Lazy<Task<detail::awaitable_return_t<Awaitable>>> spawn(Awaitable aw,
+                                                        Priority priority) {
+    co_return co_await detail::ForkTaskAwaiter<Awaitable>(
+        std::move(aw), std::nullopt, priority);
+}
+
+template <detail::awaitable Awaitable>
+Lazy<void> spawn_background(Awaitable aw, Priority priority) {
+    co_await detail::ForkTaskBackgroundAwaiter<Awaitable>(
+        std::move(aw), std::nullopt, priority);
+}
+
 } // namespace corio
\ No newline at end of file
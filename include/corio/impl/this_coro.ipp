@@ -6,6 +6,8 @@ namespace corio::this_coro {
 
 inline auto do_yield() { return corio::detail::YieldAwaiter{}; }
 
+inline auto consume_budget() { return corio::detail::BudgetAwaiter{}; }
+
 template <typename Rep, typename Period>
 auto sleep_for(const std::chrono::duration<Rep, Period> &duration) {
     return corio::detail::SleepAwaiter(duration);
@@ -0,0 +1,638 @@
+#pragma once
+
+#include "corio/detail/assert.hpp"
+#include "corio/detail/frame_allocator.hpp"
+#include "corio/detail/mpsc_queue.hpp"
+#include "corio/work_stealing_pool.hpp"
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+namespace corio {
+
+template <typename Function>
+struct WorkStealingPool::FunctionJob : WorkStealingPool::Job {
+    explicit FunctionJob(Function function)
+        : Job{nullptr, &FunctionJob::complete}, function(std::move(function)) {
+    }
+
+    static void complete(Job *job, bool invoke) {
+        // Free the job before running it, so that it can be reused by the
+        // jobs posted from the function
+        auto *self = static_cast<FunctionJob *>(job);
+        Function function(std::move(self->function));
+        self->~FunctionJob();
+        detail::deallocate_frame(self, sizeof(FunctionJob));
+        if (invoke) {
+            std::move(function)();
+        }
+    }
+
+    Function function;
+};
+
+// Serial queue of a pool, lock-free like SerialExecutor. Its jobs are only
+// popped by the worker that runs the queue, or that claimed it, and there is
+// at most one since the queue is only scheduled or claimed by whoever sets
+// `scheduled_`.
+class WorkStealingPool::SerialQueue : public WorkStealingPool::Job {
+public:
+    SerialQueue(WorkStealingPool *pool, Priority priority) noexcept
+        : Job{nullptr, &SerialQueue::complete_}, pool_(pool),
+          priority_(priority) {}
+
+    Priority priority() const noexcept { return priority_; }
+
+    void add_ref() noexcept { refs_.fetch_add(1, std::memory_order_relaxed); }
+
+    void release() noexcept {
+        if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+        }
+    }
+
+    void post(Job *job) {
+        jobs_.push(job);
+        bool idle = false;
+        if (scheduled_.compare_exchange_strong(idle, true)) {
+            add_ref(); // Held while the queue is scheduled on the pool
+            pool_->schedule_(this, false, priority_);
+        }
+    }
+
+    bool try_claim();
+
+    // Queue whose handler runs on this thread, which is the claimed one
+    // once a claim succeeds
+    static inline thread_local SerialQueue *current = nullptr;
+
+private:
+    // Jobs run before giving other queues a chance
+    static constexpr std::size_t BATCH_SIZE = 32;
+
+    static void complete_(Job *job, bool invoke);
+
+    static void release_claimed_();
+
+    // Clears `scheduled_` once the queue looks empty. Returns false if a job
+    // was pushed before, in which case the queue is still scheduled.
+    bool go_idle_() noexcept {
+        scheduled_.store(false);
+        bool idle = false;
+        return jobs_.empty() ||
+               !scheduled_.compare_exchange_strong(idle, true);
+    }
+
+private:
+    std::atomic<std::size_t> refs_ = 0;
+    WorkStealingPool *pool_;
+    Priority priority_;
+
+    std::atomic<bool> scheduled_ = false;
+    detail::MpscQueue<Job> jobs_;
+
+    // Queues claimed while running the current job, linked by `next`
+    static inline thread_local SerialQueue *claimed_ = nullptr;
+};
+
+inline bool WorkStealingPool::SerialQueue::try_claim() {
+    SerialQueue *running = current;
+    if (running == this) {
+        return true;
+    }
+    if (running == nullptr || running->pool_ != pool_) {
+        return false;
+    }
+    // Jobs posted meanwhile wait for the release
+    bool idle = false;
+    if (!scheduled_.compare_exchange_strong(idle, true)) {
+        return false;
+    }
+    add_ref();
+    next.store(claimed_, std::memory_order_relaxed);
+    claimed_ = this;
+    // Until the current job returns, the thread runs on behalf of this queue
+    current = this;
+    return true;
+}
+
+inline void WorkStealingPool::SerialQueue::release_claimed_() {
+    while (SerialQueue *claimed = claimed_) {
+        claimed_ = static_cast<SerialQueue *>(
+            claimed->next.load(std::memory_order_relaxed));
+        claimed->next.store(nullptr, std::memory_order_relaxed);
+        if (claimed->go_idle_()) {
+            claimed->release();
+        } else {
+            // Keeps the reference
+            claimed->pool_->schedule_(claimed, false, claimed->priority_);
+        }
+    }
+}
+
+inline void WorkStealingPool::SerialQueue::complete_(Job *job, bool invoke) {
+    auto *self = static_cast<SerialQueue *>(job);
+    if (!invoke) {
+        while (Job *next = self->jobs_.pop()) {
+            next->complete(next, false);
+        }
+        self->release();
+        return;
+    }
+
+    SerialQueue *prev = std::exchange(current, self);
+    for (std::size_t i = 0; i < BATCH_SIZE; i++) {
+        Job *next = self->jobs_.pop();
+        if (next == nullptr) {
+            if (self->go_idle_()) {
+                current = prev;
+                self->release();
+                return;
+            }
+            break; // The push may not be linked yet, so come back later
+        }
+        next->complete(next, true);
+        current = self;
+        release_claimed_();
+    }
+    current = prev;
+    self->pool_->schedule_(self, /*yield=*/true, self->priority_);
+}
+
+inline void WorkStealingPool::JobQueue::push(Job *job) noexcept {
+    job->next.store(nullptr, std::memory_order_relaxed);
+    if (tail_ != nullptr) {
+        tail_->next.store(job, std::memory_order_relaxed);
+    } else {
+        head_ = job;
+    }
+    tail_ = job;
+    size_++;
+}
+
+inline WorkStealingPool::Job *WorkStealingPool::JobQueue::pop() noexcept {
+    Job *job = head_;
+    if (job != nullptr) {
+        head_ = job->next.load(std::memory_order_relaxed);
+        if (head_ == nullptr) {
+            tail_ = nullptr;
+        }
+        size_--;
+    }
+    return job;
+}
+
+inline void WorkStealingPool::JobQueue::append(JobQueue &other) noexcept {
+    if (other.head_ == nullptr) {
+        return;
+    }
+    if (tail_ != nullptr) {
+        tail_->next.store(other.head_, std::memory_order_relaxed);
+    } else {
+        head_ = other.head_;
+    }
+    tail_ = other.tail_;
+    size_ += other.size_;
+    other = JobQueue{};
+}
+
+inline bool WorkStealingPool::LocalQueue::empty() const noexcept {
+    return head_.load(std::memory_order_acquire) ==
+           tail_.load(std::memory_order_acquire);
+}
+
+inline bool WorkStealingPool::LocalQueue::push(Job *job) noexcept {
+    std::size_t tail = tail_.load(std::memory_order_relaxed);
+    // Acquire, so that thieves are done reading the slot about to be reused
+    if (tail - head_.load(std::memory_order_acquire) >= CAPACITY) {
+        return false;
+    }
+    slots_[tail % CAPACITY].store(job, std::memory_order_relaxed);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+inline WorkStealingPool::Job *WorkStealingPool::LocalQueue::pop() noexcept {
+    std::size_t head = head_.load(std::memory_order_acquire);
+    while (head != tail_.load(std::memory_order_acquire)) {
+        Job *job = slots_[head % CAPACITY].load(std::memory_order_relaxed);
+        if (head_.compare_exchange_weak(head, head + 1,
+                                        std::memory_order_acq_rel,
+                                        std::memory_order_acquire)) {
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+inline WorkStealingPool::JobQueue
+WorkStealingPool::LocalQueue::take_half() noexcept {
+    Job *jobs[CAPACITY / 2];
+    std::size_t count;
+    std::size_t head = head_.load(std::memory_order_acquire);
+    do {
+        count = (tail_.load(std::memory_order_relaxed) - head) / 2;
+        for (std::size_t i = 0; i < count; i++) {
+            jobs[i] = slots_[(head + i) % CAPACITY].load(
+                std::memory_order_relaxed);
+        }
+    } while (!head_.compare_exchange_weak(head, head + count,
+                                          std::memory_order_acq_rel,
+                                          std::memory_order_acquire));
+    JobQueue taken;
+    for (std::size_t i = 0; i < count; i++) {
+        taken.push(jobs[i]);
+    }
+    return taken;
+}
+
+inline WorkStealingPool::Job *
+WorkStealingPool::LocalQueue::steal_from(LocalQueue &victim) noexcept {
+    std::size_t tail = tail_.load(std::memory_order_relaxed);
+    std::size_t room =
+        CAPACITY - (tail - head_.load(std::memory_order_acquire));
+    std::size_t count;
+    std::size_t head = victim.head_.load(std::memory_order_acquire);
+    do {
+        std::size_t available =
+            victim.tail_.load(std::memory_order_acquire) - head;
+        count = std::min(available - available / 2, room);
+        if (count == 0) {
+            return nullptr;
+        }
+        // Copied past our tail, where no one else looks, and published once
+        // the CAS has made them ours
+        for (std::size_t i = 0; i < count; i++) {
+            Job *job = victim.slots_[(head + i) % CAPACITY].load(
+                std::memory_order_relaxed);
+            slots_[(tail + i) % CAPACITY].store(job,
+                                                std::memory_order_relaxed);
+        }
+    } while (!victim.head_.compare_exchange_weak(head, head + count,
+                                                 std::memory_order_acq_rel,
+                                                 std::memory_order_acquire));
+    // Run the last one
+    tail_.store(tail + count - 1, std::memory_order_release);
+    return slots_[(tail + count - 1) % CAPACITY].load(
+        std::memory_order_relaxed);
+}
+
+inline WorkStealingPool::WorkStealingPool(std::size_t thread_count)
+    : WorkStealingPool(CpuPlacement{std::vector<CpuPlacement::Cpu>(
+          std::max<std::size_t>(thread_count, 1))}) {}
+
+inline WorkStealingPool::WorkStealingPool(const CpuPlacement &placement)
+    : workers_(std::max<std::size_t>(placement.thread_count(), 1)),
+      started_(static_cast<std::ptrdiff_t>(workers_.size())) {
+    std::random_device seed;
+    for (std::size_t i = 0; i < workers_.size(); i++) {
+        CpuPlacement::Cpu cpu;
+        if (i < placement.cpus.size()) {
+            cpu = placement.cpus[i];
+        }
+        threads_.emplace_back(&WorkStealingPool::start_worker_, this, i, cpu,
+                              seed());
+    }
+    started_.wait();
+}
+
+inline void WorkStealingPool::start_worker_(std::size_t index,
+                                            CpuPlacement::Cpu cpu,
+                                            unsigned seed) {
+    // Pinned before allocating anything, so that the worker and the frame
+    // pool of this thread are placed on the local node
+    detail::pin_this_thread(cpu);
+    workers_[index] = std::make_unique<Worker>();
+    Worker &self = *workers_[index];
+    self.rng.seed(seed);
+    self.node = cpu.node;
+    // No one may steal before every worker is there
+    started_.arrive_and_wait();
+    run_worker_(self);
+}
+
+inline WorkStealingPool::~WorkStealingPool() {
+    stop();
+    join();
+    shutdown();
+    destroy_pending_();
+}
+
+inline WorkStealingPool::executor_type
+WorkStealingPool::get_executor() noexcept {
+    return executor_type(this, false);
+}
+
+inline void WorkStealingPool::stop() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mu_);
+        stopped_.store(true);
+    }
+    sleep_cv_.notify_all();
+}
+
+inline void WorkStealingPool::join() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mu_);
+        joining_.store(true);
+    }
+    sleep_cv_.notify_all();
+    for (auto &thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+template <typename Function>
+WorkStealingPool::Job *WorkStealingPool::make_job_(Function &&function) {
+    using FunctionJobType = FunctionJob<std::decay_t<Function>>;
+    static_assert(alignof(FunctionJobType) <=
+                      __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+                  "Over-aligned functions are not supported");
+    void *block = detail::allocate_pool_frame(sizeof(FunctionJobType));
+    try {
+        return new (block) FunctionJobType(std::forward<Function>(function));
+    } catch (...) {
+        detail::deallocate_frame(block, sizeof(FunctionJobType));
+        throw;
+    }
+}
+
+inline void WorkStealingPool::schedule_(Job *job, bool yield,
+                                        Priority priority) {
+    Worker *worker = current_pool_ == this ? current_worker_ : nullptr;
+    if (priority == Priority::high) {
+        push_shared_(high_priority_, job);
+    } else if (priority == Priority::low) {
+        push_shared_(low_priority_, job);
+    } else if (worker != nullptr) {
+        if (!yield) {
+            job = worker->lifo.exchange(job, std::memory_order_acq_rel);
+        }
+        if (job != nullptr && !worker->queue.push(job)) {
+            JobQueue overflow = worker->queue.take_half();
+            overflow.push(job);
+            push_shared_(injector_, overflow);
+        }
+    } else {
+        push_shared_(injector_, job);
+    }
+
+    // Pairs with park_(): either the worker going to sleep sees the job, or
+    // the sleeper is seen here
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleepers_.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> lock(sleep_mu_);
+        sleep_cv_.notify_one();
+    }
+}
+
+inline void WorkStealingPool::run_worker_(Worker &self) {
+    current_pool_ = this;
+    current_worker_ = &self;
+    std::size_t tick = 0;
+    while (!stopped_.load(std::memory_order_relaxed)) {
+        if (Job *job = next_job_(self, tick++)) {
+            job->complete(job, true);
+        } else if (!park_()) {
+            break;
+        }
+    }
+    current_worker_ = nullptr;
+    current_pool_ = nullptr;
+}
+
+inline WorkStealingPool::Job *WorkStealingPool::next_job_(Worker &self,
+                                                         std::size_t tick) {
+    Job *job = nullptr;
+    if (tick % LOW_PRIORITY_INTERVAL == 0) {
+        job = pop_shared_(low_priority_);
+    }
+    bool high_first = tick % NORMAL_PRIORITY_INTERVAL != 0;
+    if (job == nullptr && high_first) {
+        job = pop_shared_(high_priority_);
+    }
+    if (job == nullptr && tick % INJECTOR_INTERVAL == 0) {
+        job = pop_shared_(injector_);
+    }
+    if (job == nullptr && self.lifo_polls < MAX_LIFO_POLLS) {
+        job = self.lifo.exchange(nullptr, std::memory_order_acq_rel);
+        if (job != nullptr) {
+            self.lifo_polls++;
+            return job;
+        }
+    }
+    self.lifo_polls = 0;
+    if (job == nullptr) {
+        job = self.queue.pop();
+    }
+    if (job == nullptr) {
+        job = self.lifo.exchange(nullptr, std::memory_order_acq_rel);
+    }
+    if (job == nullptr) {
+        job = pop_shared_(injector_);
+    }
+    if (job == nullptr) {
+        job = steal_(self);
+    }
+    if (job == nullptr && !high_first) {
+        job = pop_shared_(high_priority_);
+    }
+    if (job == nullptr) {
+        job = pop_shared_(low_priority_);
+    }
+    return job;
+}
+
+inline void WorkStealingPool::push_shared_(SharedQueue &shared, Job *job) {
+    std::lock_guard<std::mutex> lock(shared.mu);
+    shared.queue.push(job);
+    shared.size.fetch_add(1, std::memory_order_release);
+}
+
+inline void WorkStealingPool::push_shared_(SharedQueue &shared,
+                                           JobQueue &jobs) {
+    std::size_t count = jobs.size();
+    std::lock_guard<std::mutex> lock(shared.mu);
+    shared.queue.append(jobs);
+    shared.size.fetch_add(count, std::memory_order_release);
+}
+
+inline WorkStealingPool::Job *
+WorkStealingPool::pop_shared_(SharedQueue &shared) {
+    if (shared.size.load(std::memory_order_acquire) == 0) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(shared.mu);
+    Job *job = shared.queue.pop();
+    if (job != nullptr) {
+        shared.size.fetch_sub(1, std::memory_order_relaxed);
+    }
+    return job;
+}
+
+inline WorkStealingPool::Job *WorkStealingPool::steal_(Worker &self) {
+    std::size_t count = workers_.size();
+    std::size_t start = self.rng() % count;
+    // Workers on the same node first
+    for (std::size_t i = 0; i < 2 * count; i++) {
+        Worker &victim = *workers_[(start + i) % count];
+        bool same_node = victim.node == self.node;
+        if (&victim == &self || same_node != (i < count)) {
+            continue;
+        }
+
+        if (Job *job = self.queue.steal_from(victim.queue)) {
+            return job;
+        }
+        Job *job = victim.lifo.exchange(nullptr, std::memory_order_acq_rel);
+        if (job != nullptr) {
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+inline bool WorkStealingPool::has_queued_() const noexcept {
+    for (const SharedQueue *shared :
+         {&injector_, &high_priority_, &low_priority_}) {
+        if (shared->size.load(std::memory_order_relaxed) != 0) {
+            return true;
+        }
+    }
+    for (const auto &worker : workers_) {
+        if (!worker->queue.empty() ||
+            worker->lifo.load(std::memory_order_relaxed) != nullptr) {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline bool WorkStealingPool::park_() {
+    std::unique_lock<std::mutex> lock(sleep_mu_);
+    // Pairs with the fence in schedule_()
+    sleepers_.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    bool keep_running;
+    while (true) {
+        if (stopped_.load() || drained_) {
+            keep_running = false;
+            break;
+        }
+        if (has_queued_()) {
+            keep_running = true;
+            break;
+        }
+        // No job can be running once every worker is parked
+        if (joining_.load() && work_.load() == 0 &&
+            sleepers_.load() == workers_.size()) {
+            drained_ = true;
+            sleep_cv_.notify_all();
+            keep_running = false;
+            break;
+        }
+        sleep_cv_.wait(lock);
+    }
+    sleepers_.fetch_sub(1);
+    return keep_running;
+}
+
+inline void WorkStealingPool::work_started_() noexcept {
+    work_.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void WorkStealingPool::work_finished_() noexcept {
+    if (work_.fetch_sub(1) == 1 && joining_.load()) {
+        std::lock_guard<std::mutex> lock(sleep_mu_);
+        sleep_cv_.notify_all();
+    }
+}
+
+inline void WorkStealingPool::destroy_pending_() {
+    // Destroying a job may not post new ones, but be defensive about it
+    bool found = true;
+    while (found) {
+        found = false;
+        for (SharedQueue *shared :
+             {&injector_, &high_priority_, &low_priority_}) {
+            while (Job *job = shared->queue.pop()) {
+                job->complete(job, false);
+                found = true;
+            }
+        }
+        for (auto &worker : workers_) {
+            if (Job *job = worker->lifo.exchange(nullptr)) {
+                job->complete(job, false);
+                found = true;
+            }
+            while (Job *job = worker->queue.pop()) {
+                job->complete(job, false);
+                found = true;
+            }
+        }
+    }
+}
+
+inline WorkStealingPool::executor_type::executor_type(WorkStealingPool *pool,
+                                                      bool tracked) noexcept
+    : pool_(pool), tracked_(tracked) {
+    if (tracked_) {
+        pool_->work_started_();
+    }
+}
+
+inline WorkStealingPool::executor_type &
+WorkStealingPool::executor_type::operator=(
+    const executor_type &other) noexcept {
+    if (this != &other) {
+        if (other.tracked_) {
+            other.pool_->work_started_();
+        }
+        if (tracked_) {
+            pool_->work_finished_();
+        }
+        pool_ = other.pool_;
+        tracked_ = other.tracked_;
+    }
+    return *this;
+}
+
+inline WorkStealingPool::executor_type::~executor_type() {
+    if (tracked_) {
+        pool_->work_finished_();
+    }
+}
+
+template <typename Function>
+void WorkStealingPool::executor_type::execute(Function &&function) const {
+    pool_->schedule_(make_job_(std::forward<Function>(function)));
+}
+
+inline WorkStealingPool::serial_executor_type::serial_executor_type(
+    const executor_type &executor, Priority priority)
+    : inner_(executor.context().get_executor()),
+      queue_(new SerialQueue(&executor.context(), priority)) {}
+
+template <typename Function>
+void WorkStealingPool::serial_executor_type::execute(
+    Function &&function) const {
+    queue_->post(make_job_(std::forward<Function>(function)));
+}
+
+inline Priority
+WorkStealingPool::serial_executor_type::priority() const noexcept {
+    return queue_->priority();
+}
+
+inline bool WorkStealingPool::serial_executor_type::try_claim() const {
+    return queue_->try_claim();
+}
+
+inline bool WorkStealingPool::serial_executor_type::running_in_this_thread()
+    const noexcept {
+    return SerialQueue::current == queue_.get();
+}
+
+} // namespace corio
@@ -54,9 +54,9 @@ public:
 
     void execute();
 
-    template <typename PromiseType>
+    template <typename Handle>
     std::coroutine_handle<promise_type>
-    chain_coroutine(std::coroutine_handle<PromiseType> caller_handle);
+    chain_coroutine(Handle caller_handle);
 
     auto operator co_await();
 
@@ -4,12 +4,13 @@
 
 namespace corio {
 
-struct use_corio_t {
-    constexpr use_corio_t() {}
+namespace detail {
 
+// Lets asio objects use `Token` as their default completion token
+template <typename Token> struct DefaultCompletionToken {
     template <typename InnerExecutor>
     struct executor_with_default : InnerExecutor {
-        using default_completion_token_type = use_corio_t;
+        using default_completion_token_type = Token;
 
         executor_with_default(const InnerExecutor &inner_executor)
             : InnerExecutor(inner_executor) {}
@@ -38,8 +39,23 @@ struct use_corio_t {
     }
 };
 
+} // namespace detail
+
+struct use_corio_t : detail::DefaultCompletionToken<use_corio_t> {
+    constexpr use_corio_t() {}
+};
+
 inline constexpr use_corio_t use_corio;
 
+// Like use_corio, but co_await returns all the completion arguments as a
+// std::tuple, error code included, instead of throwing on errors
+struct use_corio_nothrow_t
+    : detail::DefaultCompletionToken<use_corio_nothrow_t> {
+    constexpr use_corio_nothrow_t() {}
+};
+
+inline constexpr use_corio_nothrow_t use_corio_nothrow;
+
 } // namespace corio
 
 namespace asio {
@@ -53,7 +69,23 @@ struct async_result<corio::use_corio_t, void(Args...)> {
         auto packed_init_args =
             std::make_tuple(std::forward<InitArgs>(args)...);
         using PackagedInitArgs = decltype(packed_init_args);
-        return corio::detail::Operation<Initiation, PackagedInitArgs, Args...>{
+        return corio::detail::Operation<corio::detail::ResultBuilder,
+                                        Initiation, PackagedInitArgs, Args...>{
+            std::move(initiation), std::move(packed_init_args)};
+    }
+};
+
+template <typename... Args>
+struct async_result<corio::use_corio_nothrow_t, void(Args...)> {
+
+    template <class Initiation, class... InitArgs>
+    static auto initiate(Initiation &&initiation, corio::use_corio_nothrow_t,
+                         InitArgs &&...args) {
+        auto packed_init_args =
+            std::make_tuple(std::forward<InitArgs>(args)...);
+        using PackagedInitArgs = decltype(packed_init_args);
+        return corio::detail::Operation<corio::detail::TupleResultBuilder,
+                                        Initiation, PackagedInitArgs, Args...>{
             std::move(initiation), std::move(packed_init_args)};
     }
 };
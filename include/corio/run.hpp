@@ -1,6 +1,8 @@
 #pragma once
 
+#include "corio/cpu_placement.hpp"
 #include "corio/detail/concepts.hpp"
+#include "corio/detail/executor_type.hpp"
 #include "corio/detail/type_traits.hpp"
 #include <asio.hpp>
 
@@ -10,10 +12,35 @@ template <typename Executor, detail::awaitable Awaitable>
 inline detail::awaitable_return_t<Awaitable> block_on(const Executor &executor,
                                                       Awaitable aw);
 
+#if !defined(CORIO_STATIC_EXECUTOR_TYPE) && !defined(CORIO_SINGLE_THREADED)
+
 template <detail::awaitable Awaitable>
 inline detail::awaitable_return_t<Awaitable> run(Awaitable aw,
                                                  bool multi_thread = true);
 
+// Runs on a multi-threaded runtime with its workers pinned to the given CPUs
+template <detail::awaitable Awaitable>
+inline detail::awaitable_return_t<Awaitable>
+run(Awaitable aw, const CpuPlacement &placement);
+
+#else
+
+// Runs on the calling thread. Tasks on the pool need serial executors of
+// their own and the synchronization between threads, so the multi-threaded
+// runtime is not available in this build.
+template <detail::awaitable Awaitable>
+inline detail::awaitable_return_t<Awaitable> run(Awaitable aw);
+
+template <detail::awaitable Awaitable>
+detail::awaitable_return_t<Awaitable> run(Awaitable aw,
+                                          bool multi_thread) = delete;
+
+template <detail::awaitable Awaitable>
+detail::awaitable_return_t<Awaitable>
+run(Awaitable aw, const CpuPlacement &placement) = delete;
+
+#endif
+
 } // namespace corio
 
 #include "corio/impl/run.ipp"
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "corio/cpu_placement.hpp"
+#include "corio/detail/concepts.hpp"
+#include "corio/detail/type_traits.hpp"
+#include "corio/task.hpp"
+#include "corio/work_stealing_pool.hpp"
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace corio {
+
+// Long-lived multi-threaded runtime, for programs that enter corio many times.
+// The threads are started on first use and kept until the runtime is
+// destroyed, so that later entries run on warm threads with warm frame pools.
+class Runtime {
+public:
+    explicit Runtime(
+        std::size_t thread_count = std::thread::hardware_concurrency());
+
+    // Pins the threads to the given CPUs
+    explicit Runtime(const CpuPlacement &placement);
+
+    Runtime(const Runtime &) = delete;
+    Runtime &operator=(const Runtime &) = delete;
+
+public:
+    std::size_t thread_count() const noexcept {
+        return placement_.thread_count();
+    }
+
+    // Whether the threads have been started
+    bool started() const noexcept { return started_.load(); }
+
+    // A new serial executor, on which a task may run
+    WorkStealingPool::serial_executor_type make_serial_executor();
+
+    template <detail::awaitable Awaitable>
+    detail::awaitable_return_t<Awaitable> block_on(Awaitable aw);
+
+    template <detail::awaitable Awaitable>
+    [[nodiscard]] Task<detail::awaitable_return_t<Awaitable>>
+    spawn(Awaitable aw);
+
+    template <detail::awaitable Awaitable> void spawn_background(Awaitable aw);
+
+private:
+    WorkStealingPool &pool_ref_();
+
+private:
+    CpuPlacement placement_;
+    std::once_flag start_;
+    std::optional<WorkStealingPool> pool_;
+    std::atomic<bool> started_ = false;
+};
+
+} // namespace corio
+
+#include "corio/impl/runtime.ipp"
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "corio/detail/intrusive_ptr.hpp"
+#include <asio.hpp>
+#include <atomic>
+#include <cstddef>
+
+namespace corio {
+
+// Runs the functions posted to it one at a time and in order on an inner
+// executor, like a strand. Unlike asio strands, which share a fixed set of
+// locked implementations, each serial executor owns a lock-free queue, so
+// unrelated tasks never contend. Posting to an idle queue schedules it on the
+// inner executor, the winner of a CAS on its `scheduled` flag doing so.
+class SerialExecutor {
+public:
+    explicit SerialExecutor(const asio::any_io_executor &inner);
+
+public:
+    asio::execution_context &
+    query(asio::execution::context_t) const noexcept;
+
+    static constexpr asio::execution::blocking_t
+    query(asio::execution::blocking_t) noexcept {
+        return asio::execution::blocking.never;
+    }
+
+    SerialExecutor
+    require(asio::execution::blocking_t::never_t) const noexcept {
+        return *this;
+    }
+
+    template <typename Function> void execute(Function &&function) const;
+
+    const asio::any_io_executor &get_inner_executor() const noexcept;
+
+    bool running_in_this_thread() const noexcept;
+
+    friend bool operator==(const SerialExecutor &a,
+                           const SerialExecutor &b) noexcept {
+        return a.queue_.get() == b.queue_.get();
+    }
+
+    friend bool operator!=(const SerialExecutor &a,
+                           const SerialExecutor &b) noexcept {
+        return !(a == b);
+    }
+
+private:
+    class Queue;
+
+    template <typename Function> struct FunctionNode;
+
+    detail::IntrusivePtr<Queue> queue_;
+};
+
+} // namespace corio
+
+#include "corio/impl/serial_executor.ipp"
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "corio/cpu_placement.hpp"
+#include "corio/detail/concepts.hpp"
+#include "corio/detail/type_traits.hpp"
+#include "corio/task.hpp"
+#include <asio.hpp>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace corio {
+
+// Thread-per-core runtime: each shard is a single-threaded io_context running
+// on a thread of its own. A task stays on the shard it is spawned on, which
+// serializes it without a strand, and spawn() inside a task defaults to the
+// same shard. Work crosses shards only by spawning there with spawn_on(), or
+// by posting to the executor of the shard.
+class ShardedRuntime {
+public:
+    using executor_type = asio::io_context::executor_type;
+
+    explicit ShardedRuntime(
+        std::size_t shard_count = std::thread::hardware_concurrency());
+
+    // Pins the shards to the given CPUs
+    explicit ShardedRuntime(const CpuPlacement &placement);
+
+    ShardedRuntime(const ShardedRuntime &) = delete;
+    ShardedRuntime &operator=(const ShardedRuntime &) = delete;
+
+    ~ShardedRuntime();
+
+public:
+    std::size_t shard_count() const noexcept { return shards_.size(); }
+
+    executor_type get_executor(std::size_t shard) const;
+
+    // Makes the shards exit, leaving pending handlers unrun
+    void stop();
+
+    // The runtime running the calling thread, if any
+    static ShardedRuntime *current() noexcept { return current_runtime_; }
+
+    // The shard running the calling thread, if current() is not null
+    static std::size_t current_shard() noexcept { return current_shard_; }
+
+private:
+    struct Shard {
+        asio::io_context context{ASIO_CONCURRENCY_HINT_1};
+        std::optional<asio::executor_work_guard<executor_type>> work;
+        std::thread thread;
+    };
+
+    static inline thread_local ShardedRuntime *current_runtime_ = nullptr;
+    static inline thread_local std::size_t current_shard_ = 0;
+
+private:
+    std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+// Spawns the task on a shard of the runtime running the calling thread
+template <detail::awaitable Awaitable>
+[[nodiscard]] Task<detail::awaitable_return_t<Awaitable>>
+spawn_on(std::size_t shard, Awaitable aw);
+
+template <detail::awaitable Awaitable>
+void spawn_background_on(std::size_t shard, Awaitable aw);
+
+} // namespace corio
+
+#include "corio/impl/sharded_runtime.ipp"
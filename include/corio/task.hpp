@@ -1,15 +1,25 @@
 #pragma once
 
 #include "corio/detail/concepts.hpp"
+#include "corio/detail/intrusive_ptr.hpp"
 #include "corio/detail/serial_runner.hpp"
 #include "corio/detail/task_shared_state.hpp"
 #include "corio/detail/type_traits.hpp"
+#include <optional>
 
 namespace corio {
 
 template <typename T> class Task;
 template <typename T> class Lazy;
 
+// Passed to spawn() to let the task allocate all its coroutine frames from an
+// arena of its own, which is freed at once when the task finishes or aborts
+struct use_arena_t {
+    std::size_t chunk_size = detail::FrameArena::DEFAULT_CHUNK_SIZE;
+};
+
+inline constexpr use_arena_t use_arena{};
+
 template <detail::awaitable Awaitable>
 [[nodiscard]] Lazy<Task<detail::awaitable_return_t<Awaitable>>>
 spawn(Awaitable aw);
@@ -24,8 +34,39 @@ Lazy<void> spawn_background(Awaitable aw);
 template <typename Executor, detail::awaitable Awaitable>
 void spawn_background(const Executor &executor, Awaitable aw);
 
+template <detail::awaitable Awaitable>
+[[nodiscard]] Lazy<Task<detail::awaitable_return_t<Awaitable>>>
+spawn(Awaitable aw, use_arena_t arena);
+
+template <typename Executor, detail::awaitable Awaitable>
+[[nodiscard]] Task<detail::awaitable_return_t<Awaitable>>
+spawn(const Executor &executor, Awaitable aw, use_arena_t arena);
+
+template <detail::awaitable Awaitable>
+Lazy<void> spawn_background(Awaitable aw, use_arena_t arena);
+
+template <typename Executor, detail::awaitable Awaitable>
+void spawn_background(const Executor &executor, Awaitable aw,
+                      use_arena_t arena);
+
+// The priority of the spawned task, which is otherwise that of the current
+// one. Only tasks on a WorkStealingPool, as under run(), are told apart.
+template <detail::awaitable Awaitable>
+[[nodiscard]] Lazy<Task<detail::awaitable_return_t<Awaitable>>>
+spawn(Awaitable aw, Priority priority);
+
+template <detail::awaitable Awaitable>
+Lazy<void> spawn_background(Awaitable aw, Priority priority);
+
 template <typename T> class AbortHandle;
 
+// How an aborted task is torn down. Either way, it never resumes again: it
+// is destroyed instead the next time one of its coroutines would be resumed.
+// An immediate abort also posts one handler to the executor of the task, to
+// destroy it at once where it is parked, cancelling the operation it awaits.
+// A deferred abort posts nothing, and suits aborting many tasks at once.
+enum class AbortMode { immediate, deferred };
+
 template <typename T> class [[nodiscard]] Task {
 public:
     using SharedState = detail::TaskSharedState<T>;
@@ -37,6 +78,10 @@ public:
     explicit Task(Awaitable aw, const Executor &executor)
         : Task(std::move(aw), detail::SerialRunner{executor}) {}
 
+    template <detail::awaitable Awaitable>
+    explicit Task(Awaitable aw, const detail::SerialRunner &runner,
+                  use_arena_t arena);
+
 public:
     Task() = default;
 
@@ -59,7 +104,7 @@ public:
 
     Result<T> get_result();
 
-    bool abort();
+    bool abort(AbortMode mode = AbortMode::immediate);
 
     AbortHandle<T> get_abort_handle();
 
@@ -68,19 +113,25 @@ public:
     auto operator co_await() const;
 
 private:
-    std::shared_ptr<SharedState> state_;
+    template <detail::awaitable Awaitable>
+    void launch_(Awaitable aw, const detail::SerialRunner &runner,
+                 std::optional<use_arena_t> arena);
+
+private:
+    detail::IntrusivePtr<SharedState> state_;
 };
 
 template <typename T> class AbortHandle {
 public:
     using SharedState = typename Task<T>::SharedState;
 
-    explicit AbortHandle(std::shared_ptr<SharedState> state) : state_(state) {}
+    explicit AbortHandle(detail::IntrusivePtr<SharedState> state)
+        : state_(std::move(state)) {}
 
-    bool abort();
+    bool abort(AbortMode mode = AbortMode::immediate);
 
 private:
-    std::shared_ptr<SharedState> state_;
+    detail::IntrusivePtr<SharedState> state_;
 };
 
 } // namespace corio
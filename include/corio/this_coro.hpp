@@ -10,6 +10,8 @@ inline constexpr corio::detail::yield_t yield;
 
 inline auto do_yield();
 
+inline auto consume_budget();
+
 template <typename Rep, typename Period>
 inline auto sleep_for(const std::chrono::duration<Rep, Period> &duration);
 
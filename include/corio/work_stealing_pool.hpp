@@ -0,0 +1,314 @@
+#pragma once
+
+#include "corio/cpu_placement.hpp"
+#include "corio/detail/intrusive_ptr.hpp"
+#include <asio.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <latch>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace corio {
+
+// Scheduling class of the tasks on a WorkStealingPool
+enum class Priority { low, normal, high };
+
+// Multi-threaded execution context with a run queue per worker. Jobs posted
+// from a worker take its LIFO slot, pushing the previous occupant to its local
+// queue; jobs posted from other threads go to a shared injector queue. Local
+// queues are lock-free rings, a full one moving half of its jobs to the
+// injector. Idle workers steal half of the local queue of a randomly chosen
+// worker, trying the workers on their own NUMA node first.
+//
+// Tasks spawned on the pool are serialized by a `serial_executor_type` each,
+// instead of an asio strand. Serial executors of high or low priority are
+// scheduled through queues of their own: high ones go first, except every
+// NORMAL_PRIORITY_INTERVAL jobs of a worker, while low ones only run when
+// there is nothing else to do, or every LOW_PRIORITY_INTERVAL jobs, so that
+// neither is starved.
+class WorkStealingPool : public asio::execution_context {
+public:
+    class executor_type;
+    class serial_executor_type;
+
+    explicit WorkStealingPool(
+        std::size_t thread_count = std::thread::hardware_concurrency());
+
+    // Pins the workers to the given CPUs
+    explicit WorkStealingPool(const CpuPlacement &placement);
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    ~WorkStealingPool();
+
+public:
+    executor_type get_executor() noexcept;
+
+    // Makes the workers exit as soon as possible, leaving pending jobs unrun
+    void stop();
+
+    // Waits for the workers to run out of work and exit
+    void join();
+
+    std::size_t thread_count() const noexcept { return workers_.size(); }
+
+private:
+    struct Job {
+        // Atomic for the lock-free queues of serial executors, accessed
+        // relaxed everywhere else
+        std::atomic<Job *> next = nullptr;
+        // Runs the job if `invoke` is true, and frees it
+        void (*complete)(Job *job, bool invoke) = nullptr;
+    };
+
+    template <typename Function> struct FunctionJob;
+
+    class JobQueue {
+    public:
+        bool empty() const noexcept { return head_ == nullptr; }
+
+        std::size_t size() const noexcept { return size_; }
+
+        void push(Job *job) noexcept;
+
+        Job *pop() noexcept;
+
+        void append(JobQueue &other) noexcept;
+
+    private:
+        Job *head_ = nullptr;
+        Job *tail_ = nullptr;
+        std::size_t size_ = 0;
+    };
+
+    // Bounded ring pushed to and popped from by its worker, and stolen from
+    // by the others. Positions only grow, so whoever wins the CAS on `head_`
+    // knows that the jobs it read before were not taken meanwhile.
+    class LocalQueue {
+    public:
+        static constexpr std::size_t CAPACITY = 256;
+
+        bool empty() const noexcept;
+
+        // Owner only, returns false if the queue is full
+        bool push(Job *job) noexcept;
+
+        Job *pop() noexcept;
+
+        // Owner only, takes the older half of the jobs
+        JobQueue take_half() noexcept;
+
+        // Moves half of the jobs of `victim` to this queue, which belongs to
+        // the calling worker, and returns one of them
+        Job *steal_from(LocalQueue &victim) noexcept;
+
+    private:
+        std::atomic<std::size_t> head_ = 0;
+        std::atomic<std::size_t> tail_ = 0;
+        std::atomic<Job *> slots_[CAPACITY] = {};
+    };
+
+    class SerialQueue;
+
+    struct SharedQueue {
+        std::mutex mu;
+        JobQueue queue;
+        std::atomic<std::size_t> size = 0;
+    };
+
+    struct Worker {
+        LocalQueue queue;
+        std::atomic<Job *> lifo = nullptr;
+        std::size_t lifo_polls = 0;
+        std::minstd_rand rng;
+        int node = 0;
+    };
+
+    // Bounds on how long the LIFO slot, local queues and high priority jobs
+    // can starve the rest
+    static constexpr std::size_t MAX_LIFO_POLLS = 3;
+    static constexpr std::size_t INJECTOR_INTERVAL = 61;
+    static constexpr std::size_t NORMAL_PRIORITY_INTERVAL = 7;
+    static constexpr std::size_t LOW_PRIORITY_INTERVAL = 47;
+
+    template <typename Function> static Job *make_job_(Function &&function);
+
+    void schedule_(Job *job, bool yield = false,
+                   Priority priority = Priority::normal);
+
+    void start_worker_(std::size_t index, CpuPlacement::Cpu cpu,
+                       unsigned seed);
+
+    void run_worker_(Worker &self);
+
+    Job *next_job_(Worker &self, std::size_t tick);
+
+    static void push_shared_(SharedQueue &shared, Job *job);
+
+    static void push_shared_(SharedQueue &shared, JobQueue &jobs);
+
+    static Job *pop_shared_(SharedQueue &shared);
+
+    Job *steal_(Worker &self);
+
+    bool has_queued_() const noexcept;
+
+    bool park_();
+
+    void work_started_() noexcept;
+
+    void work_finished_() noexcept;
+
+    void destroy_pending_();
+
+    static inline thread_local WorkStealingPool *current_pool_ = nullptr;
+    static inline thread_local Worker *current_worker_ = nullptr;
+
+private:
+    // Each allocated by its own thread, on the node it is pinned to
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::thread> threads_;
+    std::latch started_;
+
+    SharedQueue injector_;
+    SharedQueue high_priority_;
+    SharedQueue low_priority_;
+
+    // Tracked executors, which keep the workers from exiting on join()
+    std::atomic<std::size_t> work_ = 0;
+
+    std::mutex sleep_mu_;
+    std::condition_variable sleep_cv_;
+    std::atomic<std::size_t> sleepers_ = 0;
+    std::atomic<bool> stopped_ = false;
+    std::atomic<bool> joining_ = false;
+    // Set once all workers are parked with nothing left to do on join()
+    bool drained_ = false;
+};
+
+class WorkStealingPool::executor_type {
+public:
+    executor_type(const executor_type &other) noexcept
+        : executor_type(other.pool_, other.tracked_) {}
+
+    executor_type &operator=(const executor_type &other) noexcept;
+
+    ~executor_type();
+
+public:
+    WorkStealingPool &query(asio::execution::context_t) const noexcept {
+        return *pool_;
+    }
+
+    static constexpr asio::execution::blocking_t
+    query(asio::execution::blocking_t) noexcept {
+        return asio::execution::blocking.never;
+    }
+
+    constexpr asio::execution::outstanding_work_t
+    query(asio::execution::outstanding_work_t) const noexcept {
+        if (tracked_) {
+            return asio::execution::outstanding_work.tracked;
+        }
+        return asio::execution::outstanding_work.untracked;
+    }
+
+    executor_type require(asio::execution::blocking_t::never_t) const noexcept {
+        return *this;
+    }
+
+    executor_type
+    require(asio::execution::outstanding_work_t::tracked_t) const noexcept {
+        return executor_type(pool_, true);
+    }
+
+    executor_type
+    require(asio::execution::outstanding_work_t::untracked_t) const noexcept {
+        return executor_type(pool_, false);
+    }
+
+    template <typename Function> void execute(Function &&function) const;
+
+    WorkStealingPool &context() const noexcept { return *pool_; }
+
+    bool running_in_this_thread() const noexcept {
+        return current_pool_ == pool_;
+    }
+
+    friend bool operator==(const executor_type &a,
+                           const executor_type &b) noexcept {
+        return a.pool_ == b.pool_ && a.tracked_ == b.tracked_;
+    }
+
+    friend bool operator!=(const executor_type &a,
+                           const executor_type &b) noexcept {
+        return !(a == b);
+    }
+
+private:
+    friend class WorkStealingPool;
+
+    executor_type(WorkStealingPool *pool, bool tracked) noexcept;
+
+    WorkStealingPool *pool_;
+    bool tracked_;
+};
+
+// Runs the jobs posted to it one at a time and in order, like a strand
+class WorkStealingPool::serial_executor_type {
+public:
+    explicit serial_executor_type(const executor_type &executor,
+                                  Priority priority = Priority::normal);
+
+public:
+    WorkStealingPool &query(asio::execution::context_t) const noexcept {
+        return inner_.context();
+    }
+
+    static constexpr asio::execution::blocking_t
+    query(asio::execution::blocking_t) noexcept {
+        return asio::execution::blocking.never;
+    }
+
+    serial_executor_type
+    require(asio::execution::blocking_t::never_t) const noexcept {
+        return *this;
+    }
+
+    template <typename Function> void execute(Function &&function) const;
+
+    const executor_type &get_inner_executor() const noexcept { return inner_; }
+
+    Priority priority() const noexcept;
+
+    bool running_in_this_thread() const noexcept;
+
+    // Lets the caller run a handler of this executor right away, if it is
+    // idle and the calling thread runs a handler of another serial executor
+    // of the same pool. Jobs posted meanwhile wait until that handler returns.
+    bool try_claim() const;
+
+    friend bool operator==(const serial_executor_type &a,
+                           const serial_executor_type &b) noexcept {
+        return a.queue_.get() == b.queue_.get();
+    }
+
+    friend bool operator!=(const serial_executor_type &a,
+                           const serial_executor_type &b) noexcept {
+        return !(a == b);
+    }
+
+private:
+    executor_type inner_;
+    detail::IntrusivePtr<SerialQueue> queue_;
+};
+
+} // namespace corio
+
+#include "corio/impl/work_stealing_pool.ipp"
@@ -0,0 +1,132 @@
+// Built with CORIO_SINGLE_THREADED
+#include <asio.hpp>
+#include <atomic>
+#include <corio/detail/resume_token.hpp>
+#include <corio/exceptions.hpp>
+#include <corio/run.hpp>
+#include <corio/select.hpp>
+#include <corio/task.hpp>
+#include <corio/this_coro.hpp>
+#include <doctest/doctest.h>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+template <typename Awaitable>
+concept runnable_on_threads =
+    requires(Awaitable aw) { corio::run(std::move(aw), true); };
+
+static_assert(!runnable_on_threads<corio::Lazy<void>>);
+
+} // namespace
+
+TEST_CASE("test single-threaded mode") {
+    SUBCASE("spawn and await tasks") {
+        auto f = [](int i) -> corio::Lazy<int> {
+            co_await corio::this_coro::yield;
+            co_return i;
+        };
+        auto g = [&]() -> corio::Lazy<int> {
+            std::vector<corio::Task<int>> tasks;
+            for (int i = 0; i < 10; i++) {
+                tasks.push_back(co_await corio::spawn(f(i)));
+            }
+            int sum = 0;
+            for (auto &task : tasks) {
+                sum += co_await task;
+            }
+            co_return sum;
+        };
+
+        CHECK(corio::run(g()) == 45);
+    }
+
+    SUBCASE("spawn background") {
+        asio::io_context ctx;
+        std::vector<int> order;
+
+        auto f = [&](int i) -> corio::Lazy<void> {
+            order.push_back(i);
+            co_await corio::this_coro::yield;
+            order.push_back(i + 2);
+        };
+
+        corio::spawn_background(ctx.get_executor(), f(1));
+        corio::spawn_background(ctx.get_executor(), f(2));
+        ctx.run();
+
+        CHECK(order == std::vector<int>{1, 2, 3, 4});
+    }
+
+    SUBCASE("abort task") {
+        auto f = []() -> corio::Lazy<int> {
+            co_await corio::this_coro::sleep_for(10s);
+            co_return 42;
+        };
+        auto g = [&]() -> corio::Lazy<void> {
+            auto task = co_await corio::spawn(f());
+            co_await corio::this_coro::yield;
+            CHECK(task.abort());
+            CHECK_THROWS_AS(co_await task, corio::CancellationError);
+            CHECK(task.is_cancelled());
+        };
+
+        corio::run(g());
+    }
+
+    SUBCASE("abort task deferred") {
+        auto f = []() -> corio::Lazy<void> {
+            while (true) {
+                co_await corio::this_coro::yield;
+            }
+        };
+        auto g = [&]() -> corio::Lazy<void> {
+            auto task = co_await corio::spawn(f());
+            co_await corio::this_coro::yield;
+            CHECK(task.abort(corio::AbortMode::deferred));
+            CHECK_THROWS_AS(co_await task, corio::CancellationError);
+        };
+
+        corio::run(g());
+    }
+
+    SUBCASE("stale ticket while another thread reuses its slot") {
+        using corio::detail::ResumeToken;
+        ResumeToken::Ticket ticket;
+        // The slot goes back to the global free list once the thread exits
+        std::thread([&] { ticket = ResumeToken().ticket(); }).join();
+
+        std::atomic<bool> stop = false;
+        std::thread other([&] {
+            while (!stop) {
+                ResumeToken token;
+                token.cancel();
+            }
+        });
+        bool stale = true;
+        for (int i = 0; i < 10000; i++) {
+            stale = stale && !ticket.valid();
+        }
+        stop = true;
+        other.join();
+        CHECK(stale);
+    }
+
+    SUBCASE("select cancels the loser") {
+        auto f = []() -> corio::Lazy<int> {
+            co_await corio::this_coro::yield;
+            co_return 1;
+        };
+        auto g = [&]() -> corio::Lazy<void> {
+            auto r = co_await corio::select(
+                f(), corio::this_coro::sleep_for(10s));
+            CHECK(r.index() == 0);
+        };
+
+        corio::run(g());
+    }
+}
@@ -0,0 +1,80 @@
+// Built with CORIO_EXECUTOR_TYPE=asio::io_context::executor_type
+#include <asio.hpp>
+#include <corio/exceptions.hpp>
+#include <corio/run.hpp>
+#include <corio/task.hpp>
+#include <corio/this_coro.hpp>
+#include <doctest/doctest.h>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+template <typename Awaitable>
+concept runnable_on_threads =
+    requires(Awaitable aw) { corio::run(std::move(aw), true); };
+
+static_assert(!runnable_on_threads<corio::Lazy<void>>);
+
+} // namespace
+
+TEST_CASE("test static executor type") {
+    SUBCASE("executor keeps its type") {
+        auto f = []() -> corio::Lazy<void> {
+            auto ex = co_await corio::this_coro::executor;
+            static_assert(
+                std::is_same_v<decltype(ex), asio::io_context::executor_type>);
+        };
+
+        corio::run(f());
+    }
+
+    SUBCASE("spawn and await tasks") {
+        auto f = []() -> corio::Lazy<int> {
+            co_await corio::this_coro::yield;
+            co_return 42;
+        };
+        auto g = [&]() -> corio::Lazy<int> {
+            auto task = co_await corio::spawn(f());
+            co_return co_await task;
+        };
+
+        CHECK(corio::run(g()) == 42);
+    }
+
+    SUBCASE("spawn background") {
+        asio::io_context ctx;
+        std::vector<int> order;
+
+        auto f = [&](int i) -> corio::Lazy<void> {
+            order.push_back(i);
+            co_await corio::this_coro::yield;
+            order.push_back(i + 2);
+        };
+
+        corio::spawn_background(ctx.get_executor(), f(1));
+        corio::spawn_background(ctx.get_executor(), f(2));
+        ctx.run();
+
+        CHECK(order == std::vector<int>{1, 2, 3, 4});
+    }
+
+    SUBCASE("abort task") {
+        auto f = []() -> corio::Lazy<int> {
+            co_await corio::this_coro::sleep_for(10s);
+            co_return 42;
+        };
+        auto g = [&]() -> corio::Lazy<void> {
+            auto task = co_await corio::spawn(f());
+            co_await corio::this_coro::yield;
+            CHECK(task.abort());
+            CHECK_THROWS_AS(co_await task, corio::CancellationError);
+            CHECK(task.is_cancelled());
+        };
+
+        corio::run(g());
+    }
+}
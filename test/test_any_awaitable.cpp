@@ -5,6 +5,7 @@
 #include <corio/run.hpp>
 #include <corio/task.hpp>
 #include <corio/this_coro.hpp>
+#include <coroutine>
 #include <doctest/doctest.h>
 #include <type_traits>
 #include <variant>
@@ -103,4 +104,57 @@ TEST_CASE("test any awaitable") {
         asio::thread_pool pool(1);
         corio::block_on(pool.get_executor(), h());
     }
-}
\ No newline at end of file
+
+    SUBCASE("large and borrowed awaitable") {
+        using AnyAwaitableType = corio::AnyAwaitable<int>;
+
+        struct LargeAwaitable {
+            corio::Lazy<int> lazy;
+            char padding[256] = {};
+
+            auto operator co_await() { return lazy.operator co_await(); }
+        };
+
+        auto f = [&]() -> corio::Lazy<int> { co_return 42; };
+        auto g = [&]() -> corio::Lazy<void> {
+            AnyAwaitableType a1 = LargeAwaitable{f()};
+            auto lazy = f();
+            AnyAwaitableType a2(lazy);
+
+            std::vector<AnyAwaitableType> v;
+            v.push_back(std::move(a1));
+            v.push_back(std::move(a2));
+
+            for (auto &a : v) {
+                auto result = co_await a;
+                CHECK(result == 42);
+            }
+        };
+
+        asio::thread_pool pool(1);
+        corio::block_on(pool.get_executor(), g());
+    }
+    SUBCASE("awaiter taking a plain handle") {
+        using AnyAwaitableType = corio::AnyAwaitable<int>;
+
+        struct PlainAwaiter {
+            asio::thread_pool::executor_type executor;
+
+            bool await_ready() const noexcept { return false; }
+
+            void await_suspend(std::coroutine_handle<> handle) {
+                asio::post(executor, [handle]() { handle.resume(); });
+            }
+
+            int await_resume() const noexcept { return 42; }
+        };
+
+        asio::thread_pool pool(1);
+        auto g = [&]() -> corio::Lazy<void> {
+            AnyAwaitableType a = PlainAwaiter{pool.get_executor()};
+            CHECK(co_await a == 42);
+        };
+
+        corio::block_on(pool.get_executor(), g());
+    }
+}
@@ -54,4 +54,30 @@ TEST_CASE("test build result") {
                                      corio::Result<std::tuple<int, double>>>);
         CHECK_THROWS(result.result());
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("test completion handler allocator") {
+    using Handler =
+        corio::detail::CompletionHandler<corio::detail::ResultBuilder,
+                                         asio::error_code, std::size_t>;
+
+    Handler::ResultType result;
+    corio::detail::ResumeToken token;
+    Handler handler(std::noop_coroutine(), asio::cancellation_slot(), result,
+                    token.ticket());
+
+    auto alloc = asio::get_associated_allocator(handler);
+    static_assert(std::is_same_v<decltype(alloc),
+                                 corio::detail::RecyclingAllocator<void>>);
+
+    using ByteAlloc = std::allocator_traits<
+        decltype(alloc)>::template rebind_alloc<std::byte>;
+    ByteAlloc byte_alloc(alloc);
+    std::byte *block = byte_alloc.allocate(200);
+    byte_alloc.deallocate(block, 200);
+#ifndef CORIO_DISABLE_FRAME_POOL
+    std::byte *block2 = byte_alloc.allocate(200);
+    CHECK(block == block2); // Recycled
+    byte_alloc.deallocate(block2, 200);
+#endif
+}
@@ -0,0 +1,65 @@
+#include <algorithm>
+#include <asio.hpp>
+#include <corio/cpu_placement.hpp>
+#include <corio/lazy.hpp>
+#include <corio/run.hpp>
+#include <corio/sharded_runtime.hpp>
+#include <corio/work_stealing_pool.hpp>
+#include <doctest/doctest.h>
+#include <future>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+TEST_CASE("test cpu placement") {
+    SUBCASE("parse cpu list") {
+        using corio::detail::parse_cpu_list;
+        CHECK(parse_cpu_list("0-3,8,10-11") ==
+              std::vector<int>{0, 1, 2, 3, 8, 10, 11});
+        CHECK(parse_cpu_list("") == std::vector<int>{});
+        CHECK(parse_cpu_list("x") == std::vector<int>{});
+    }
+
+    SUBCASE("detect cpus") {
+        auto placement = corio::CpuPlacement::detect();
+        CHECK(placement.thread_count() > 0);
+        CHECK(std::is_sorted(placement.cpus.begin(), placement.cpus.end(),
+                             [](const auto &a, const auto &b) {
+                                 return a.node < b.node;
+                             }));
+    }
+
+    SUBCASE("run on pinned pool") {
+        auto placement = corio::CpuPlacement::detect();
+        auto f = []() -> corio::Lazy<int> { co_return 42; };
+        CHECK(corio::run(f(), placement) == 42);
+    }
+
+#if defined(__linux__)
+    SUBCASE("pin workers") {
+        auto detected = corio::CpuPlacement::detect();
+        auto cpu = detected.cpus.front();
+        corio::CpuPlacement placement{{cpu, cpu}};
+
+        corio::WorkStealingPool pool(placement);
+        CHECK(pool.thread_count() == 2);
+        std::vector<std::future<int>> cpus;
+        for (int i = 0; i < 10; i++) {
+            std::packaged_task<int()> job([] { return sched_getcpu(); });
+            cpus.push_back(job.get_future());
+            asio::post(pool.get_executor(), std::move(job));
+        }
+        for (auto &ran_on : cpus) {
+            CHECK(ran_on.get() == cpu.id);
+        }
+
+        corio::ShardedRuntime runtime(placement);
+        std::packaged_task<int()> job([] { return sched_getcpu(); });
+        auto ran_on = job.get_future();
+        asio::post(runtime.get_executor(1), std::move(job));
+        CHECK(ran_on.get() == cpu.id);
+    }
+#endif
+}
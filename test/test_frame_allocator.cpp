@@ -0,0 +1,179 @@
+#include <corio/detail/frame_allocator.hpp>
+#include <cstdint>
+#include <doctest/doctest.h>
+#include <thread>
+#include <vector>
+
+TEST_CASE("test frame allocator") {
+
+    SUBCASE("allocate and deallocate") {
+        std::vector<std::pair<void *, std::size_t>> frames;
+        for (std::size_t size : {1, 48, 100, 1000, 4000, 100000}) {
+            void *frame = corio::detail::allocate_frame(size);
+            CHECK(frame != nullptr);
+            CHECK(reinterpret_cast<std::uintptr_t>(frame) %
+                      __STDCPP_DEFAULT_NEW_ALIGNMENT__ ==
+                  0);
+            frames.emplace_back(frame, size);
+        }
+        for (auto [frame, size] : frames) {
+            corio::detail::deallocate_frame(frame, size);
+        }
+    }
+
+#ifndef CORIO_DISABLE_FRAME_POOL
+    SUBCASE("reuse freed frame") {
+        void *frame = corio::detail::allocate_frame(100);
+        corio::detail::deallocate_frame(frame, 100);
+        void *frame2 = corio::detail::allocate_frame(100);
+        CHECK(frame == frame2);
+        corio::detail::deallocate_frame(frame2, 100);
+    }
+
+    SUBCASE("reuse frame freed by another thread") {
+        void *frame = corio::detail::allocate_frame(3000);
+        std::thread t(
+            [&]() { corio::detail::deallocate_frame(frame, 3000); });
+        t.join();
+        void *frame2 = corio::detail::allocate_frame(3000);
+        CHECK(frame == frame2);
+        corio::detail::deallocate_frame(frame2, 3000);
+    }
+#endif
+
+    SUBCASE("frame outlives its thread") {
+        void *frame = nullptr;
+        std::thread t([&]() { frame = corio::detail::allocate_frame(300); });
+        t.join();
+        CHECK(frame != nullptr);
+        corio::detail::deallocate_frame(frame, 300);
+    }
+
+    SUBCASE("free frames concurrently") {
+        constexpr std::size_t n = 1000;
+        std::vector<void *> frames;
+        for (std::size_t i = 0; i < n; i++) {
+            frames.push_back(corio::detail::allocate_frame(i % 500));
+        }
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < 4; t++) {
+            threads.emplace_back([&, t]() {
+                for (std::size_t i = t; i < n; i += 4) {
+                    corio::detail::deallocate_frame(frames[i], i % 500);
+                }
+            });
+        }
+        for (auto &t : threads) {
+            t.join();
+        }
+    }
+}
+
+TEST_CASE("test frame arena") {
+    using corio::detail::FrameArena;
+
+    SUBCASE("allocate from current arena") {
+        FrameArena *arena = FrameArena::create(1024);
+        std::vector<std::pair<void *, std::size_t>> frames;
+        {
+            FrameArena::Scope scope(arena);
+            for (std::size_t size : {1, 48, 100, 1000, 3000, 100000}) {
+                void *frame = corio::detail::allocate_frame(size);
+                CHECK(reinterpret_cast<std::uintptr_t>(frame) %
+                          __STDCPP_DEFAULT_NEW_ALIGNMENT__ ==
+                      0);
+                frames.emplace_back(frame, size);
+            }
+            for (auto [frame, size] : frames) {
+                corio::detail::deallocate_frame(frame, size);
+            }
+        }
+        CHECK(FrameArena::current == nullptr);
+        arena->retire();
+    }
+
+    SUBCASE("reuse freed frame") {
+        FrameArena *arena = FrameArena::create();
+        {
+            FrameArena::Scope scope(arena);
+            void *frame = corio::detail::allocate_frame(100);
+            corio::detail::deallocate_frame(frame, 100);
+            void *frame2 = corio::detail::allocate_frame(100);
+            CHECK(frame == frame2);
+            corio::detail::deallocate_frame(frame2, 100);
+        }
+        arena->retire();
+    }
+
+    SUBCASE("frame outlives retired arena") {
+        FrameArena *arena = FrameArena::create();
+        std::vector<void *> frames;
+        {
+            FrameArena::Scope scope(arena);
+            for (std::size_t i = 0; i < 100; i++) {
+                frames.push_back(corio::detail::allocate_frame(200));
+            }
+            arena->retire();
+            CHECK(FrameArena::current == nullptr);
+        }
+        std::thread t([&]() {
+            for (void *frame : frames) {
+                corio::detail::deallocate_frame(frame, 200);
+            }
+        });
+        t.join();
+    }
+}
+
+TEST_CASE("test frame slab") {
+    using corio::detail::FrameSlab;
+
+    SUBCASE("allocate contiguous frames") {
+        FrameSlab slab;
+        slab.reserve(4);
+        std::vector<void *> frames;
+        for (std::size_t i = 0; i < 4; i++) {
+            frames.push_back(slab.allocate(100));
+        }
+        for (std::size_t i = 1; i < 4; i++) {
+            CHECK(static_cast<std::byte *>(frames[i]) -
+                      static_cast<std::byte *>(frames[i - 1]) ==
+                  128);
+        }
+        // Frames beyond the reserved count fall back to the pool
+        void *extra = slab.allocate(100);
+        CHECK(extra != nullptr);
+        corio::detail::deallocate_frame(extra, 100);
+        for (void *frame : frames) {
+            corio::detail::deallocate_frame(frame, 100);
+        }
+    }
+
+    SUBCASE("frame outlives slab") {
+        void *frame = nullptr;
+        {
+            FrameSlab slab;
+            slab.reserve(2);
+            frame = slab.allocate(200);
+            FrameSlab moved = std::move(slab);
+        }
+        std::thread t([&]() { corio::detail::deallocate_frame(frame, 200); });
+        t.join();
+    }
+
+    SUBCASE("block comes from the current arena") {
+        auto *arena = corio::detail::FrameArena::create();
+        void *frame = nullptr;
+        {
+            corio::detail::FrameArena::Scope scope(arena);
+            FrameSlab slab;
+            slab.reserve(2);
+            frame = slab.allocate(100);
+            CHECK(corio::detail::header_of(frame)->deallocate ==
+                  &FrameSlab::deallocate);
+        }
+        // The block is given back to the arena with the last frame
+        corio::detail::deallocate_frame(frame, 100);
+        arena->retire();
+    }
+}
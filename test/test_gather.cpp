@@ -3,6 +3,7 @@
 #include <corio/detail/defer.hpp>
 #include <corio/gather.hpp>
 #include <corio/lazy.hpp>
+#include <corio/operation.hpp>
 #include <corio/operators.hpp>
 #include <corio/run.hpp>
 #include <corio/this_coro.hpp>
@@ -488,6 +489,79 @@ TEST_CASE("test gather") {
 
         CHECK(called);
     }
+
+    SUBCASE("gather resumes parent directly") {
+        asio::io_context ctx;
+        auto ex = ctx.get_executor();
+        std::vector<int> order;
+
+        auto f = [&](int i) -> corio::Lazy<int> {
+            co_await corio::this_coro::yield;
+            asio::post(ex, [&, i] { order.push_back(i); });
+            co_return i;
+        };
+        auto g = []() -> corio::Lazy<int> { co_return 0; };
+        auto h = [&]() -> corio::Lazy<void> {
+            asio::post(ex, [&] { order.push_back(0); });
+            // Children done while launched do not suspend the parent
+            co_await corio::gather(g(), g());
+            order.push_back(-1);
+            // The last child resumes the parent before its own handlers
+            co_await corio::gather(f(1), f(2));
+            order.push_back(3);
+        };
+
+        corio::spawn_background(ex, h());
+        ctx.run();
+
+        CHECK(order == std::vector<int>{-1, 0, 3, 1, 2});
+    }
+
+    SUBCASE("gather resumes parent on its runner") {
+        asio::io_context ctx;
+        auto ex = ctx.get_executor();
+        asio::thread_pool pool2(1);
+        auto work = asio::make_work_guard(ctx);
+
+        auto f = [&]() -> corio::Lazy<void> {
+            // The child goes on from the thread of the pool
+            co_await asio::post(pool2.get_executor(), corio::use_corio);
+        };
+        auto h = [&]() -> corio::Lazy<void> {
+            co_await corio::gather(f(), f());
+            CHECK(ex.running_in_this_thread());
+            ctx.stop();
+        };
+
+        corio::spawn_background(ex, h());
+        ctx.run();
+    }
+
+    SUBCASE("gather launched from a foreign executor") {
+        asio::io_context ctx;
+        auto ex = ctx.get_executor();
+        asio::thread_pool pool2(1);
+        auto work = asio::make_work_guard(ctx);
+
+        auto f = [&](int i) -> corio::Lazy<int> {
+            CHECK(ex.running_in_this_thread());
+            co_await corio::this_coro::yield;
+            co_return i;
+        };
+        auto h = [&]() -> corio::Lazy<void> {
+            for (int i = 0; i < 100; i++) {
+                // The parent goes on from the thread of the pool
+                co_await asio::post(pool2.get_executor(), corio::use_corio);
+                auto [a, b] = co_await corio::gather(f(1), f(2));
+                CHECK(a.result() + b.result() == 3);
+                CHECK(ex.running_in_this_thread());
+            }
+            ctx.stop();
+        };
+
+        corio::spawn_background(ex, h());
+        ctx.run();
+    }
 }
 
 TEST_CASE("test gather iter") {
@@ -4,9 +4,40 @@
 #include <corio/lazy.hpp>
 #include <doctest/doctest.h>
 #include <memory>
+#include <memory_resource>
 #include <thread>
 #include <vector>
 
+namespace {
+
+template <typename T> struct CountingAllocator {
+    using value_type = T;
+
+    explicit CountingAllocator(int *count) : count(count) {}
+
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U> &other) : count(other.count) {}
+
+    T *allocate(std::size_t n) {
+        (*count)++;
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T *p, std::size_t n) {
+        (*count)--;
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    int *count;
+};
+
+corio::Lazy<int> alloc_f(std::allocator_arg_t, CountingAllocator<int> alloc,
+                         int n) {
+    co_return n;
+}
+
+} // namespace
+
 TEST_CASE("test lazy") {
 
     SUBCASE("basic") {
@@ -76,4 +107,63 @@ TEST_CASE("test lazy") {
         CHECK(lazy.is_finished());
         CHECK(lazy.get_result().result() == 2);
     }
-}
\ No newline at end of file
+
+    SUBCASE("allocate frame with allocator") {
+        int count = 0;
+        CountingAllocator<int> alloc(&count);
+
+        auto f = [&](std::allocator_arg_t,
+                     CountingAllocator<int> alloc) -> corio::Lazy<int> {
+            auto inner = alloc_f(std::allocator_arg, alloc, 1);
+            CHECK(count == 2);
+            auto n = co_await inner;
+            CHECK(count == 1);
+            co_return n + 1;
+        };
+
+        auto lazy = f(std::allocator_arg, alloc);
+        CHECK(count == 1);
+
+        asio::io_context io_context;
+        corio::detail::TaskContext ctx = {
+            .runner = asio::make_strand<asio::any_io_executor>(
+                io_context.get_executor()),
+        };
+
+        lazy.set_context(&ctx);
+        lazy.execute();
+
+        io_context.run();
+
+        CHECK(lazy.is_finished());
+        CHECK(lazy.get_result().result() == 2);
+        CHECK(count == 1);
+
+        lazy.reset();
+        CHECK(count == 0);
+    }
+
+    SUBCASE("allocate frame with memory resource") {
+        std::pmr::monotonic_buffer_resource resource;
+        std::pmr::polymorphic_allocator<std::byte> alloc(&resource);
+
+        auto f = [](std::allocator_arg_t,
+                    std::pmr::polymorphic_allocator<std::byte>,
+                    int n) -> corio::Lazy<int> { co_return n; };
+
+        auto lazy = f(std::allocator_arg, alloc, 42);
+
+        asio::io_context io_context;
+        corio::detail::TaskContext ctx = {
+            .runner = asio::make_strand<asio::any_io_executor>(
+                io_context.get_executor()),
+        };
+
+        lazy.set_context(&ctx);
+        lazy.execute();
+
+        io_context.run();
+
+        CHECK(lazy.get_result().result() == 42);
+    }
+}
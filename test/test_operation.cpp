@@ -65,6 +65,43 @@ TEST_CASE("test operation") {
         corio::block_on(pool.get_executor(), f());
     }
 
+    SUBCASE("move operation before await") {
+        auto f = []() -> corio::Lazy<void> {
+            auto ex = co_await corio::this_coro::executor;
+            asio::steady_timer timer(ex, 100us);
+
+            auto op = timer.async_wait(corio::use_corio);
+            auto moved_op = std::move(op);
+
+            auto start = std::chrono::steady_clock::now();
+            co_await std::move(moved_op);
+            auto end = std::chrono::steady_clock::now();
+
+            CHECK((end - start) >= 100us);
+        };
+
+        asio::thread_pool pool(1);
+
+        corio::block_on(pool.get_executor(), f());
+    }
+
+    SUBCASE("timer operation nothrow") {
+        auto f = []() -> corio::Lazy<void> {
+            auto ex = co_await corio::this_coro::executor;
+            asio::steady_timer timer(ex, 100us);
+
+            auto [ec] = co_await timer.async_wait(corio::use_corio_nothrow);
+            CHECK_FALSE(ec);
+
+            auto r = co_await asio::post(ex, corio::use_corio_nothrow);
+            static_assert(std::is_same_v<decltype(r), std::tuple<>>);
+        };
+
+        asio::thread_pool pool(1);
+
+        corio::block_on(pool.get_executor(), f());
+    }
+
     SUBCASE("timer operation with different executor") {
         asio::thread_pool pool1(1), pool2(1);
 
@@ -202,6 +239,35 @@ TEST_CASE("test tcp operations") {
 
         asio::thread_pool pool(3);
 
+        corio::block_on(asio::make_strand(pool.get_executor()), f());
+    }
+    SUBCASE("tcp read eof nothrow") {
+        auto f = []() -> corio::Lazy<void> {
+            auto ex = co_await corio::this_coro::executor;
+
+            asio::ip::tcp::acceptor acceptor(
+                ex, asio::ip::tcp::endpoint(asio::ip::tcp::v4(), 0));
+            auto port = acceptor.local_endpoint().port();
+
+            asio::ip::tcp::socket client(ex);
+            client.connect(asio::ip::tcp::endpoint(asio::ip::tcp::v4(), port));
+
+            asio::ip::tcp::socket socket(ex);
+            auto [accept_ec] = co_await acceptor.async_accept(
+                socket, corio::use_corio_nothrow);
+            CHECK_FALSE(accept_ec);
+
+            client.close();
+
+            std::array<char, 1024> buffer;
+            auto [ec, n] = co_await socket.async_read_some(
+                asio::buffer(buffer), corio::use_corio_nothrow);
+            CHECK(ec == asio::error::eof);
+            CHECK(n == 0);
+        };
+
+        asio::thread_pool pool(1);
+
         corio::block_on(asio::make_strand(pool.get_executor()), f());
     }
 }
\ No newline at end of file
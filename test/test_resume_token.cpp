@@ -0,0 +1,52 @@
+#include <corio/detail/resume_token.hpp>
+#include <doctest/doctest.h>
+#include <optional>
+#include <thread>
+
+TEST_CASE("test resume token") {
+    using corio::detail::ResumeToken;
+
+    SUBCASE("ticket is valid until cancel") {
+        ResumeToken token;
+        auto ticket = token.ticket();
+        CHECK(ticket.valid());
+        token.cancel();
+        CHECK_FALSE(ticket.valid());
+        CHECK(token.ticket().valid());
+    }
+
+    SUBCASE("ticket is invalid after destruction") {
+        std::optional<ResumeToken> token(std::in_place);
+        auto ticket = token->ticket();
+        token.reset();
+        CHECK_FALSE(ticket.valid());
+
+        // The slot is reused by the next token
+        ResumeToken token2;
+        CHECK_FALSE(ticket.valid());
+        CHECK(token2.ticket().valid());
+    }
+
+    SUBCASE("default ticket is invalid") {
+        ResumeToken::Ticket ticket;
+        CHECK_FALSE(ticket.valid());
+    }
+
+    SUBCASE("move token") {
+        ResumeToken token;
+        auto ticket = token.ticket();
+        ResumeToken token2 = std::move(token);
+        CHECK(ticket.valid());
+        token2 = ResumeToken();
+        CHECK_FALSE(ticket.valid());
+        CHECK_FALSE(token.ticket().valid());
+    }
+
+    SUBCASE("destroy token on another thread") {
+        std::optional<ResumeToken> token(std::in_place);
+        auto ticket = token->ticket();
+        std::thread t([&]() { token.reset(); });
+        t.join();
+        CHECK_FALSE(ticket.valid());
+    }
+}
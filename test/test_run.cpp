@@ -49,6 +49,24 @@ TEST_CASE("test run") {
         }
     }
 
+    SUBCASE("test run single thread on calling thread") {
+        auto f = []() -> corio::Lazy<std::thread::id> {
+            co_return std::this_thread::get_id();
+        };
+        CHECK(corio::run(f(), /*multi_thread=*/false) ==
+              std::this_thread::get_id());
+
+        asio::thread_pool pool(1);
+        auto g = [&]() -> corio::Lazy<int> {
+            auto h = []() -> corio::Lazy<int> {
+                std::this_thread::sleep_for(1ms);
+                co_return 42;
+            };
+            co_return co_await corio::spawn(pool.get_executor(), h());
+        };
+        CHECK(corio::run(g(), /*multi_thread=*/false) == 42);
+    }
+
     SUBCASE("test block_on with common awaiter") {
         auto f = []() -> corio::Lazy<int> { co_return 42; };
 
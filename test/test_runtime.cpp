@@ -0,0 +1,65 @@
+#include <corio/lazy.hpp>
+#include <corio/runtime.hpp>
+#include <corio/task.hpp>
+#include <doctest/doctest.h>
+#include <stdexcept>
+#include <thread>
+
+TEST_CASE("test runtime") {
+    SUBCASE("start lazily") {
+        corio::Runtime runtime(2);
+        CHECK(runtime.thread_count() == 2);
+        CHECK(!runtime.started());
+        auto f = []() -> corio::Lazy<int> { co_return 42; };
+        CHECK(runtime.block_on(f()) == 42);
+        CHECK(runtime.started());
+    }
+
+    SUBCASE("reuse threads") {
+        corio::Runtime runtime(1);
+        auto f = []() -> corio::Lazy<std::thread::id> {
+            co_return std::this_thread::get_id();
+        };
+        auto id = runtime.block_on(f());
+        CHECK(id != std::this_thread::get_id());
+        for (int i = 0; i < 100; i++) {
+            CHECK(runtime.block_on(f()) == id);
+        }
+    }
+
+    SUBCASE("block on exception") {
+        corio::Runtime runtime(2);
+        auto f = []() -> corio::Lazy<void> {
+            throw std::runtime_error("error");
+            co_return;
+        };
+        CHECK_THROWS_AS(runtime.block_on(f()), std::runtime_error);
+    }
+
+    SUBCASE("spawn") {
+        corio::Runtime runtime(2);
+        auto f = []() -> corio::Lazy<int> { co_return 1; };
+        corio::Task<int> task = runtime.spawn(f());
+        auto g = [](corio::Task<int> task) -> corio::Lazy<int> {
+            co_return co_await task + 1;
+        };
+        CHECK(runtime.block_on(g(std::move(task))) == 2);
+    }
+
+    SUBCASE("spawn background") {
+        corio::Runtime runtime(2);
+        std::atomic<int> count = 0;
+        auto f = [](std::atomic<int> &count) -> corio::Lazy<void> {
+            count++;
+            count.notify_one();
+            co_return;
+        };
+        for (int i = 0; i < 10; i++) {
+            runtime.spawn_background(f(count));
+        }
+        for (int n = count.load(); n < 10; n = count.load()) {
+            count.wait(n);
+        }
+        CHECK(count == 10);
+    }
+}
@@ -9,6 +9,7 @@
 #include <corio/task.hpp>
 #include <corio/this_coro.hpp>
 #include <doctest/doctest.h>
+#include <vector>
 
 using namespace std::chrono_literals;
 
@@ -109,6 +110,29 @@ TEST_CASE("test select") {
 
         corio::block_on(pool.get_executor(), l());
     }
+
+    SUBCASE("select resumes parent directly") {
+        asio::io_context ctx;
+        auto ex = ctx.get_executor();
+        std::vector<int> order;
+
+        auto f = [&]() -> corio::Lazy<int> {
+            co_await corio::this_coro::yield;
+            asio::post(ex, [&] { order.push_back(2); });
+            co_return 1;
+        };
+        auto g = [&]() -> corio::Lazy<void> {
+            auto r =
+                co_await corio::select(f(), corio::this_coro::sleep_for(10s));
+            CHECK(r.index() == 0);
+            order.push_back(1);
+        };
+
+        corio::spawn_background(ex, g());
+        ctx.run();
+
+        CHECK(order == std::vector<int>{1, 2});
+    }
 }
 
 TEST_CASE("test select iter") {
@@ -0,0 +1,95 @@
+#include <asio.hpp>
+#include <atomic>
+#include <corio/serial_executor.hpp>
+#include <doctest/doctest.h>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST_CASE("test serial executor") {
+    SUBCASE("run in order") {
+        asio::thread_pool pool(4);
+        corio::SerialExecutor serial(pool.get_executor());
+        CHECK(serial.get_inner_executor() == pool.get_executor());
+
+        std::vector<int> order;
+        std::promise<void> done;
+        for (int i = 0; i < 1000; i++) {
+            asio::post(serial, [&, i] {
+                order.push_back(i);
+                if (i == 999) {
+                    done.set_value();
+                }
+            });
+        }
+        done.get_future().wait();
+        REQUIRE(order.size() == 1000);
+        for (int i = 0; i < 1000; i++) {
+            CHECK(order[i] == i);
+        }
+    }
+
+    SUBCASE("run one at a time") {
+        asio::thread_pool pool(4);
+        corio::SerialExecutor serial(pool.get_executor());
+
+        constexpr int n_threads = 4;
+        constexpr int n_posts = 10000;
+        std::atomic<int> running = 0;
+        std::atomic<bool> overlapped = false;
+        std::atomic<bool> not_inside = false;
+        int count = 0; // Guarded by the serial executor
+        std::promise<void> done;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < n_threads; t++) {
+            threads.emplace_back([&] {
+                for (int i = 0; i < n_posts; i++) {
+                    asio::post(serial, [&] {
+                        if (running.fetch_add(1) != 0) {
+                            overlapped = true;
+                        }
+                        if (!serial.running_in_this_thread()) {
+                            not_inside = true;
+                        }
+                        if (++count == n_threads * n_posts) {
+                            done.set_value();
+                        }
+                        running.fetch_sub(1);
+                    });
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        done.get_future().wait();
+        CHECK(!overlapped);
+        CHECK(!not_inside);
+        CHECK(!serial.running_in_this_thread());
+    }
+
+    SUBCASE("survive a throwing function") {
+        asio::io_context ctx;
+        corio::SerialExecutor serial(ctx.get_executor());
+
+        std::vector<int> order;
+        asio::post(serial, [] { throw std::runtime_error("error"); });
+        asio::post(serial, [&] { order.push_back(1); });
+        CHECK_THROWS_AS(ctx.run(), std::runtime_error);
+        CHECK(!serial.running_in_this_thread());
+
+        asio::post(serial, [&] { order.push_back(2); });
+        ctx.restart();
+        ctx.run();
+        CHECK(order == std::vector<int>{1, 2});
+    }
+
+    SUBCASE("compare") {
+        asio::thread_pool pool(1);
+        corio::SerialExecutor serial(pool.get_executor());
+        corio::SerialExecutor copy = serial;
+        CHECK(copy == serial);
+        CHECK(corio::SerialExecutor(pool.get_executor()) != serial);
+    }
+}
@@ -1,6 +1,8 @@
 #include <asio.hpp>
 #include <corio/detail/serial_runner.hpp>
 #include <doctest/doctest.h>
+#include <future>
+#include <vector>
 
 TEST_CASE("test serial runner") {
 
@@ -24,10 +26,38 @@ TEST_CASE("test serial runner") {
         CHECK(runner.get_inner_executor() == strand.get_inner_executor());
 
         auto runner2 = runner.fork_runner();
-        CHECK(runner2.get_executor() != strand); // Another strand after fork
+        CHECK(runner2.get_executor() != strand); // Another executor after fork
         CHECK(runner2.get_inner_executor() == runner.get_inner_executor());
     }
 
+    SUBCASE("accept serial executor") {
+        asio::thread_pool pool(2);
+        corio::SerialExecutor serial(pool.get_executor());
+        corio::detail::SerialRunner runner(serial);
+        CHECK(runner.get_executor() == serial);
+        CHECK(runner.get_inner_executor() == pool.get_executor());
+
+        auto runner2 = runner.fork_runner();
+        CHECK(runner2.get_executor() != serial); // Another queue after fork
+        CHECK(runner2.get_executor().target<corio::SerialExecutor>() !=
+              nullptr);
+        CHECK(runner2.get_inner_executor() == pool.get_executor());
+    }
+
+    SUBCASE("post never runs inline") {
+        asio::io_context io_context;
+        corio::detail::SerialRunner runner(io_context.get_executor());
+        std::vector<int> order;
+        runner.post([&] {
+            runner.post([&] { order.push_back(2); });
+            order.push_back(1);
+        });
+        CHECK(order.empty());
+
+        io_context.run();
+        CHECK(order == std::vector<int>{1, 2});
+    }
+
     SUBCASE("default constructor and assign") {
         corio::detail::SerialRunner runner;
         CHECK(!runner);
@@ -47,4 +77,37 @@ TEST_CASE("test serial runner") {
         CHECK(runner.get_executor() == strand);
         CHECK(runner.get_inner_executor() == strand.get_inner_executor());
     }
-}
\ No newline at end of file
+
+    SUBCASE("accept work stealing pool") {
+        corio::WorkStealingPool pool(1);
+        corio::WorkStealingPool::serial_executor_type serial(
+            pool.get_executor());
+        corio::detail::SerialRunner runner(serial);
+        CHECK(runner.get_executor() == serial);
+        CHECK(runner.get_inner_executor() == pool.get_executor());
+
+        auto runner2 = runner.fork_runner();
+        CHECK(runner2.get_executor() != serial); // Another queue after fork
+        CHECK(runner2.get_inner_executor() == pool.get_executor());
+        CHECK(runner2.priority() == corio::Priority::normal);
+
+        auto runner3 = runner.fork_runner(corio::Priority::high);
+        CHECK(runner3.priority() == corio::Priority::high);
+        CHECK(runner3.fork_runner().priority() == corio::Priority::high);
+    }
+
+    SUBCASE("running in this thread") {
+        asio::thread_pool pool(1);
+        // Any executor with running_in_this_thread() can tell
+        auto strand = asio::make_strand(pool.get_executor());
+        corio::detail::SerialRunner runner(strand);
+        CHECK_FALSE(runner.running_in_this_thread());
+
+        std::promise<std::vector<bool>> running;
+        runner.post([&] {
+            running.set_value({runner.running_in_this_thread(),
+                               runner.fork_runner().running_in_this_thread()});
+        });
+        CHECK(running.get_future().get() == std::vector<bool>{true, false});
+    }
+}
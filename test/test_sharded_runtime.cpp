@@ -0,0 +1,57 @@
+#include <asio.hpp>
+#include <atomic>
+#include <corio/lazy.hpp>
+#include <corio/run.hpp>
+#include <corio/sharded_runtime.hpp>
+#include <corio/task.hpp>
+#include <corio/this_coro.hpp>
+#include <doctest/doctest.h>
+#include <vector>
+
+TEST_CASE("test sharded runtime") {
+    SUBCASE("spawn on shards") {
+        corio::ShardedRuntime runtime(4);
+        CHECK(runtime.shard_count() == 4);
+        CHECK(corio::ShardedRuntime::current() == nullptr);
+
+        auto where = []() -> corio::Lazy<std::size_t> {
+            co_return corio::ShardedRuntime::current_shard();
+        };
+        auto f = [&]() -> corio::Lazy<std::vector<std::size_t>> {
+            std::vector<std::size_t> shards;
+            // On the current shard by default
+            auto t = co_await corio::spawn(where());
+            shards.push_back(co_await t);
+            for (std::size_t i = 0; i < runtime.shard_count(); i++) {
+                auto t2 = corio::spawn_on(i, where());
+                shards.push_back(co_await t2);
+            }
+            // Back on the shard after awaiting the others
+            shards.push_back(corio::ShardedRuntime::current_shard());
+            co_return shards;
+        };
+
+        auto shards = corio::block_on(runtime.get_executor(1), f());
+        CHECK(shards == std::vector<std::size_t>{1, 0, 1, 2, 3, 1});
+    }
+
+    SUBCASE("spawn background on shards") {
+        corio::ShardedRuntime runtime(2);
+        std::atomic<int> count = 0;
+
+        auto g = [&]() -> corio::Lazy<void> {
+            count++;
+            co_return;
+        };
+        auto f = [&]() -> corio::Lazy<void> {
+            corio::spawn_background_on(0, g());
+            corio::spawn_background_on(1, g());
+            while (count < 2) {
+                co_await corio::this_coro::yield;
+            }
+        };
+
+        corio::block_on(runtime.get_executor(0), f());
+        CHECK(count == 2);
+    }
+}
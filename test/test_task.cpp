@@ -1,6 +1,14 @@
 #include <asio.hpp>
+#include <chrono>
+#include <corio/operation.hpp>
+#include <corio/run.hpp>
+#include <corio/select.hpp>
 #include <corio/task.hpp>
+#include <corio/this_coro.hpp>
 #include <doctest/doctest.h>
+#include <vector>
+
+using namespace std::chrono_literals;
 
 namespace {
 
@@ -106,6 +114,118 @@ TEST_CASE("test task") {
         CHECK(called);
     }
 
+    SUBCASE("resume awaiter on the same executor directly") {
+        asio::io_context ctx;
+        auto ex = ctx.get_executor();
+        std::vector<int> order;
+
+        auto f = [&]() -> corio::Lazy<int> {
+            co_await corio::this_coro::yield;
+            asio::post(ex, [&] { order.push_back(2); });
+            co_return 42;
+        };
+
+        auto g = [&]() -> corio::Lazy<void> {
+            auto task = co_await corio::spawn(f());
+            CHECK(co_await task == 42);
+            order.push_back(1);
+        };
+
+        corio::spawn_background(ex, g());
+        ctx.run();
+
+        // Resumed before the handler posted by the task
+        CHECK(order == std::vector<int>{1, 2});
+    }
+
+    SUBCASE("resume awaiter on its own thread after a foreign await") {
+        asio::io_context ctx;
+        auto ex = ctx.get_executor();
+        asio::thread_pool pool(1);
+        auto work = asio::make_work_guard(ctx);
+
+        auto f = [&]() -> corio::Lazy<void> {
+            // The task finishes on the thread of the pool
+            co_await asio::post(pool.get_executor(), corio::use_corio);
+        };
+
+        auto g = [&]() -> corio::Lazy<void> {
+            auto task = co_await corio::spawn(f());
+            co_await task;
+            CHECK(ex.running_in_this_thread());
+            ctx.stop();
+        };
+
+        corio::spawn_background(ex, g());
+        ctx.run();
+    }
+
+    SUBCASE("await task again after losing a select") {
+        asio::thread_pool pool(2);
+
+        auto f = []() -> corio::Lazy<int> {
+            co_await corio::this_coro::sleep_for(5ms);
+            co_return 42;
+        };
+        auto g = [&]() -> corio::Lazy<int> {
+            auto task = co_await corio::spawn(f());
+            auto await_task = [&]() -> corio::Lazy<int> {
+                co_return co_await task;
+            };
+            auto r = co_await corio::select(
+                corio::this_coro::sleep_for(100us), await_task());
+            CHECK(r.index() == 0);
+            co_return co_await task;
+        };
+
+        CHECK(corio::block_on(asio::make_strand(pool.get_executor()), g()) ==
+              42);
+    }
+
+    SUBCASE("join tasks across threads") {
+        asio::thread_pool pool(4);
+
+        auto f = [](int i) -> corio::Lazy<int> {
+            co_await corio::this_coro::yield;
+            co_return i;
+        };
+        auto g = [&]() -> corio::Lazy<int> {
+            std::vector<corio::Task<int>> tasks;
+            for (int i = 0; i < 1000; i++) {
+                tasks.push_back(co_await corio::spawn(f(i)));
+            }
+            int sum = 0;
+            for (auto &task : tasks) {
+                sum += co_await task;
+            }
+            co_return sum;
+        };
+
+        CHECK(corio::block_on(asio::make_strand(pool.get_executor()), g()) ==
+              499500);
+    }
+
+    SUBCASE("detach task") {
+        bool called = false;
+        asio::thread_pool pool(2);
+        auto strand = asio::make_strand(pool.get_executor());
+
+        auto f = [&]() -> corio::Lazy<void> {
+            co_await SimpleAwaiter{};
+            called = true;
+        };
+
+        auto task = corio::spawn(strand, f());
+        auto handle = task.get_abort_handle();
+        CHECK(task.detach());
+        CHECK_FALSE(task);
+
+        pool.join();
+
+        CHECK(called);
+        CHECK_FALSE(handle.abort());
+    }
+
     SUBCASE("abort task basic") {
         bool called = false;
         asio::thread_pool pool(2);
@@ -271,4 +391,186 @@ TEST_CASE("test task") {
 
         CHECK(called);
     }
+
+    SUBCASE("abort task deferred") {
+        bool called = false;
+        asio::thread_pool pool(2);
+        auto strand = asio::make_strand(pool.get_executor());
+
+        auto f = []() -> corio::Lazy<int> {
+            while (true) {
+                co_await corio::this_coro::yield;
+            }
+            co_return 42;
+        };
+        auto g = [&]() -> corio::Lazy<void> {
+            auto task = co_await corio::spawn(f());
+            CHECK(task.abort(corio::AbortMode::deferred));
+            CHECK_FALSE(task.abort());
+            CHECK_THROWS_AS(co_await task, corio::CancellationError);
+            CHECK(task.is_cancelled());
+            called = true;
+        };
+
+        corio::spawn_background(strand, g());
+
+        pool.join();
+
+        CHECK(called);
+    }
+
+    SUBCASE("deferred abort skips the resumption of a sleep") {
+        bool called = false;
+        bool resumed = false;
+        asio::thread_pool pool(2);
+        auto strand = asio::make_strand(pool.get_executor());
+
+        auto f = [&]() -> corio::Lazy<void> {
+            co_await corio::this_coro::sleep_for(10ms);
+            resumed = true;
+        };
+        auto g = [&]() -> corio::Lazy<void> {
+            auto task = co_await corio::spawn(f());
+            CHECK(task.get_abort_handle().abort(corio::AbortMode::deferred));
+            CHECK_THROWS_AS(co_await task, corio::CancellationError);
+            called = true;
+        };
+
+        corio::spawn_background(strand, g());
+
+        pool.join();
+
+        CHECK(called);
+        CHECK_FALSE(resumed);
+    }
+
+    SUBCASE("abort roaming tasks") {
+        int cancelled = 0;
+        asio::thread_pool pool(4);
+        auto strand = asio::make_strand(pool.get_executor());
+
+        auto f = [&]() -> corio::Lazy<void> {
+            auto ex1 = asio::make_strand(pool.get_executor());
+            auto ex2 = asio::make_strand(pool.get_executor());
+            while (true) {
+                co_await corio::this_coro::roam_to(ex1);
+                co_await corio::this_coro::roam_to(ex2);
+            }
+        };
+        auto g = [&]() -> corio::Lazy<void> {
+            for (int i = 0; i < 100; i++) {
+                auto task = co_await corio::spawn(f());
+                co_await corio::this_coro::yield;
+                task.abort();
+                try {
+                    co_await task;
+                } catch (const corio::CancellationError &) {
+                    cancelled++;
+                }
+            }
+        };
+
+        corio::spawn_background(strand, g());
+
+        pool.join();
+
+        CHECK(cancelled == 100);
+    }
+    SUBCASE("spawn task with frame arena") {
+        bool called = false;
+        asio::thread_pool pool(2);
+        auto strand = asio::make_strand(pool.get_executor());
+
+        auto leaf = [](int i) -> corio::Lazy<int> { co_return i; };
+        auto f = [&]() -> corio::Lazy<int> {
+            int sum = 0;
+            for (int i = 0; i < 100; ++i) {
+                auto arena = corio::detail::FrameArena::current;
+                CHECK(arena != nullptr);
+                sum += co_await leaf(i);
+                co_await corio::this_coro::yield;
+                CHECK(corio::detail::FrameArena::current == arena);
+            }
+            co_return sum;
+        };
+        auto g = [&]() -> corio::Lazy<void> {
+            auto task = co_await corio::spawn(f(), corio::use_arena);
+            CHECK(co_await task == 4950);
+            called = true;
+        };
+
+        corio::spawn_background(strand, g());
+
+        pool.join();
+
+        CHECK(called);
+    }
+
+    SUBCASE("frame arena is left out on a foreign executor") {
+        asio::io_context ctx;
+        auto ex = ctx.get_executor();
+        asio::thread_pool pool2(1);
+        auto work = asio::make_work_guard(ctx);
+
+        auto leaf = [](int i) -> corio::Lazy<int> { co_return i; };
+        auto f = [&]() -> corio::Lazy<int> {
+            CHECK(corio::detail::FrameArena::current != nullptr);
+            co_await asio::post(pool2.get_executor(), corio::use_corio);
+            // Frames allocated here come from the pool of this thread
+            CHECK(corio::detail::FrameArena::current == nullptr);
+            co_return co_await leaf(1);
+        };
+        auto g = [&]() -> corio::Lazy<void> {
+            auto task = co_await corio::spawn(f(), corio::use_arena);
+            CHECK(co_await task == 1);
+            ctx.stop();
+        };
+
+        corio::spawn_background(ex, g());
+        ctx.run();
+    }
+
+    SUBCASE("frame outlives task with frame arena") {
+        asio::thread_pool pool(2);
+        auto strand = asio::make_strand(pool.get_executor());
+
+        auto leaf = []() -> corio::Lazy<int> { co_return 42; };
+        auto f = [&]() -> corio::Lazy<corio::Lazy<int>> { co_return leaf(); };
+
+        auto task =
+            corio::spawn(strand, f(), corio::use_arena_t{.chunk_size = 256});
+
+        pool.join();
+
+        // Released after the arena is retired, on another thread
+        auto result = task.get_result();
+        corio::Lazy<int> lazy = std::move(result.result());
+        CHECK(lazy.get() != nullptr);
+    }
+
+    SUBCASE("abort task with frame arena") {
+        bool called = false;
+        asio::thread_pool pool(2);
+        auto strand = asio::make_strand(pool.get_executor());
+
+        auto f = []() -> corio::Lazy<int> {
+            while (true) {
+                co_await SimpleAwaiter{};
+            }
+            co_return 42;
+        };
+        auto g = [&]() -> corio::Lazy<void> {
+            auto task = co_await corio::spawn(f(), corio::use_arena);
+            CHECK(task.abort());
+            CHECK_THROWS_AS(co_await task, corio::CancellationError);
+            CHECK(task.is_cancelled());
+            called = true;
+        };
+
+        corio::spawn_background(strand, g());
+
+        pool.join();
+
+        CHECK(called);
+    }
 }
\ No newline at end of file
@@ -83,6 +83,31 @@ TEST_CASE("test this_coro awaitable") {
         CHECK_FALSE(called);
     }
 
+    SUBCASE("consume budget") {
+        asio::io_context ctx;
+        bool other_ran = false;
+        std::size_t first_seen = 0;
+        auto f = [&]() -> corio::Lazy<void> {
+            for (std::size_t i = 1; first_seen == 0; i++) {
+                co_await corio::this_coro::consume_budget();
+                if (other_ran) {
+                    first_seen = i;
+                }
+            }
+        };
+        auto g = [&]() -> corio::Lazy<void> {
+            other_ran = true;
+            co_return;
+        };
+
+        corio::spawn_background(ctx.get_executor(), f());
+        corio::spawn_background(ctx.get_executor(), g());
+        ctx.run();
+
+        // Yields once the whole budget is used
+        CHECK(first_seen == corio::detail::TASK_BUDGET + 1);
+    }
+
     SUBCASE("test sleep for") {
         bool called = false;
         auto f = [&]() -> corio::Lazy<void> {
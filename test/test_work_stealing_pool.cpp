@@ -0,0 +1,277 @@
+#include <asio.hpp>
+#include <atomic>
+#include <corio/gather.hpp>
+#include <corio/lazy.hpp>
+#include <corio/run.hpp>
+#include <corio/task.hpp>
+#include <corio/this_coro.hpp>
+#include <corio/work_stealing_pool.hpp>
+#include <doctest/doctest.h>
+#include <functional>
+#include <future>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+TEST_CASE("test work stealing pool") {
+    SUBCASE("run posted jobs") {
+        corio::WorkStealingPool pool(4);
+        asio::any_io_executor ex = pool.get_executor();
+
+        constexpr int n = 10000;
+        std::atomic<int> count = 0;
+        std::promise<void> done;
+        for (int i = 0; i < n / 100; i++) {
+            // Jobs posted from the workers go through the local queues
+            asio::post(ex, [&, ex] {
+                for (int j = 0; j < 100; j++) {
+                    asio::post(ex, [&] {
+                        if (count.fetch_add(1) + 1 == n) {
+                            done.set_value();
+                        }
+                    });
+                }
+            });
+        }
+        done.get_future().wait();
+        CHECK(count == n);
+    }
+
+    SUBCASE("local queue overflows") {
+        corio::WorkStealingPool pool(2);
+        asio::any_io_executor ex = pool.get_executor();
+
+        constexpr int n = 1000; // More than a local queue holds
+        std::atomic<int> count = 0;
+        std::promise<void> done;
+        asio::post(ex, [&, ex] {
+            for (int i = 0; i < n; i++) {
+                asio::post(ex, [&] {
+                    if (count.fetch_add(1) + 1 == n) {
+                        done.set_value();
+                    }
+                });
+            }
+        });
+        done.get_future().wait();
+        CHECK(count == n);
+    }
+
+    SUBCASE("serial executor") {
+        corio::WorkStealingPool pool(4);
+        corio::WorkStealingPool::serial_executor_type serial(
+            pool.get_executor());
+        CHECK(serial.get_inner_executor() == pool.get_executor());
+
+        constexpr int n = 10000;
+        std::atomic<int> running = 0;
+        int next = 0;
+        bool ordered = true;
+        std::promise<void> done;
+        for (int i = 0; i < n; i++) {
+            asio::post(serial, [&, i] {
+                if (running.fetch_add(1) != 0 || next++ != i ||
+                    !serial.running_in_this_thread()) {
+                    ordered = false;
+                }
+                running.fetch_sub(1);
+                if (i == n - 1) {
+                    done.set_value();
+                }
+            });
+        }
+        done.get_future().wait();
+        CHECK(ordered);
+    }
+
+    SUBCASE("claim idle serial executor") {
+        corio::WorkStealingPool pool(1);
+        corio::WorkStealingPool::serial_executor_type a(pool.get_executor());
+        corio::WorkStealingPool::serial_executor_type b(pool.get_executor());
+        CHECK_FALSE(b.try_claim()); // Not from a worker
+
+        std::vector<int> order;
+        std::promise<void> done;
+        asio::post(a, [&] {
+            CHECK(a.try_claim());
+            CHECK(b.try_claim());
+            CHECK(b.running_in_this_thread());
+            CHECK_FALSE(a.running_in_this_thread());
+            // Runs once the current job of `a` returns
+            asio::post(b, [&] {
+                order.push_back(2);
+                done.set_value();
+            });
+            order.push_back(1);
+        });
+        done.get_future().wait();
+        CHECK(order == std::vector<int>{1, 2});
+
+        std::promise<bool> busy;
+        asio::post(a, [&] {
+            asio::post(b, [] {});
+            busy.set_value(b.try_claim());
+        });
+        CHECK_FALSE(busy.get_future().get());
+    }
+
+    SUBCASE("serial executor priorities") {
+        using corio::Priority;
+        using Serial = corio::WorkStealingPool::serial_executor_type;
+        corio::WorkStealingPool pool(1);
+        Serial low(pool.get_executor(), Priority::low);
+        Serial normal(pool.get_executor());
+        Serial high(pool.get_executor(), Priority::high);
+        CHECK(low.priority() == Priority::low);
+        CHECK(normal.priority() == Priority::normal);
+
+        std::promise<void> blocked;
+        std::promise<void> release;
+        asio::post(pool.get_executor(), [&] {
+            blocked.set_value();
+            release.get_future().wait();
+        });
+        blocked.get_future().wait();
+
+        std::vector<Priority> order;
+        std::promise<void> done;
+        asio::post(low, [&] {
+            order.push_back(Priority::low);
+            done.set_value();
+        });
+        asio::post(normal, [&] { order.push_back(Priority::normal); });
+        asio::post(high, [&] { order.push_back(Priority::high); });
+        release.set_value();
+        done.get_future().wait();
+
+        CHECK(order == std::vector<Priority>{Priority::high, Priority::normal,
+                                             Priority::low});
+    }
+
+    SUBCASE("low priority is not starved") {
+        using corio::Priority;
+        using Serial = corio::WorkStealingPool::serial_executor_type;
+        corio::WorkStealingPool pool(1);
+        Serial low(pool.get_executor(), Priority::low);
+        Serial high(pool.get_executor(), Priority::high);
+
+        std::atomic<bool> low_ran = false;
+        int rounds = 0;
+        std::promise<void> done;
+        std::function<void()> busy = [&] {
+            if (low_ran || ++rounds == 1'000'000) {
+                done.set_value();
+                return;
+            }
+            asio::post(high, busy);
+        };
+        asio::post(high, [&] {
+            asio::post(low, [&] { low_ran = true; });
+            busy();
+        });
+        done.get_future().wait();
+
+        CHECK(low_ran);
+        CHECK(rounds < 1'000'000);
+    }
+
+    SUBCASE("normal priority is not starved") {
+        using corio::Priority;
+        using Serial = corio::WorkStealingPool::serial_executor_type;
+        corio::WorkStealingPool pool(1);
+        Serial high(pool.get_executor(), Priority::high);
+
+        std::atomic<bool> normal_ran = false;
+        int rounds = 0;
+        std::promise<void> done;
+        std::function<void()> busy = [&] {
+            if (normal_ran || ++rounds == 1'000'000) {
+                done.set_value();
+                return;
+            }
+            asio::post(high, busy);
+        };
+        asio::post(high, [&] {
+            asio::post(pool.get_executor(), [&] { normal_ran = true; });
+            busy();
+        });
+        done.get_future().wait();
+
+        CHECK(normal_ran);
+        CHECK(rounds < 1'000'000);
+    }
+
+    SUBCASE("join waits for pending jobs") {
+        std::atomic<int> count = 0;
+        corio::WorkStealingPool pool(2);
+        for (int i = 0; i < 100; i++) {
+            asio::post(pool.get_executor(), [&] {
+                std::this_thread::sleep_for(100us);
+                count++;
+            });
+        }
+        pool.join();
+        CHECK(count == 100);
+    }
+
+    SUBCASE("spawn tasks") {
+        auto f = [](int i) -> corio::Lazy<int> {
+            co_await corio::this_coro::yield;
+            co_return i;
+        };
+        auto g = [&]() -> corio::Lazy<int> {
+            std::vector<corio::Task<int>> tasks;
+            for (int i = 0; i < 100; i++) {
+                tasks.push_back(co_await corio::spawn(f(i)));
+            }
+            auto results = co_await corio::gather(tasks);
+            int sum = 0;
+            for (auto &result : results) {
+                sum += result.result();
+            }
+            co_return sum;
+        };
+
+        corio::WorkStealingPool pool(4);
+        corio::WorkStealingPool::serial_executor_type serial(
+            pool.get_executor());
+        CHECK(corio::block_on(serial, g()) == 4950);
+    }
+
+    SUBCASE("spawn with priority") {
+        using corio::Priority;
+        using Serial = corio::WorkStealingPool::serial_executor_type;
+        auto priority = []() -> corio::Lazy<Priority> {
+            auto ex = co_await corio::this_coro::executor;
+            co_return ex.target<Serial>()->priority();
+        };
+        auto g = [&]() -> corio::Lazy<std::vector<Priority>> {
+            auto t1 = co_await corio::spawn(priority(), Priority::low);
+            auto t2 = co_await corio::spawn(priority());
+            std::vector<Priority> priorities;
+            priorities.push_back(co_await t1);
+            priorities.push_back(co_await t2);
+            co_return priorities;
+        };
+
+        corio::WorkStealingPool pool(2);
+        Serial serial(pool.get_executor(), Priority::high);
+        // Child tasks inherit the priority unless it is given
+        CHECK(corio::block_on(serial, g()) ==
+              std::vector<Priority>{Priority::low, Priority::high});
+    }
+
+    SUBCASE("sleep on pool") {
+        auto f = []() -> corio::Lazy<void> {
+            co_await corio::this_coro::sleep_for(10ms);
+        };
+
+        corio::WorkStealingPool pool(2);
+        corio::WorkStealingPool::serial_executor_type serial(
+            pool.get_executor());
+        auto start = std::chrono::steady_clock::now();
+        corio::block_on(serial, f());
+        CHECK(std::chrono::steady_clock::now() - start >= 10ms);
+    }
+}